@@ -0,0 +1,15 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+
+out vec4 Color;
+
+uniform mat4 projection;
+
+void main()
+{
+    // World-space segment endpoints, same camera matrix as the sprites.
+    Color = aColor;
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec4 aColor;
+
+out vec2 TexCoords;
+out vec4 Color;
+
+uniform mat4 projection;
+
+void main()
+{
+    // Positions arrive in world space; the CPU kernel already applied the model transform.
+    TexCoords = aTexCoords;
+    Color = aColor;
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+}
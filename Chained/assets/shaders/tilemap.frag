@@ -0,0 +1,22 @@
+#version 330 core
+
+in vec2 Cell;
+out vec4 FragColor;
+
+uniform usampler2D tileIds;
+uniform sampler2D tileset;
+uniform int chunkTiles;
+uniform int tilePixels;
+uniform int tilesetColumns;
+uniform int tileCount;
+
+void main()
+{
+    ivec2 cell = min(ivec2(floor(Cell)), ivec2(chunkTiles - 1));
+    int id = int(texelFetch(tileIds, cell, 0).r);
+    if (id >= tileCount) discard;
+
+    ivec2 tile = ivec2(id % tilesetColumns, id / tilesetColumns);
+    ivec2 texel = tile * tilePixels + min(ivec2(fract(Cell) * float(tilePixels)), ivec2(tilePixels - 1));
+    FragColor = texelFetch(tileset, texel, 0);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos; // unit quad over one chunk
+
+out vec2 Cell;
+
+uniform mat4 projection;
+uniform vec2 chunkOrigin;
+uniform float tileSize;
+uniform int chunkTiles;
+
+void main()
+{
+    Cell = aPos * float(chunkTiles);
+    gl_Position = projection * vec4(chunkOrigin + Cell * tileSize, 0.0, 1.0);
+}
@@ -35,6 +35,9 @@ namespace Chained {
         shader->setUniform("image", 0);
 
         atlas = std::make_unique<SpriteAtlas>("assets/textures/sprites.json");
+        playBtn.slice = atlas->resolveSlice(playBtn.sliceName);
+        settingsBtn.slice = atlas->resolveSlice(settingsBtn.sliceName);
+        exitBtn.slice = atlas->resolveSlice(exitBtn.sliceName);
 
         float centerX = static_cast<float>(Engine::SCREEN_WIDTH) * 0.5f;
         float startY = static_cast<float>(Engine::SCREEN_HEIGHT) * 0.3f;
@@ -139,7 +142,7 @@ namespace Chained {
             btn.pressed = false;
             if (btn.hovered)
             {
-                if (btn.sliceName == std::string("play_btn"))
+                if (&btn == &playBtn)
                     engine->run(std::make_unique<TestState>("scenes/testsix.json"));
                 // TODO: open settings menu when you have it
             }
@@ -149,9 +152,8 @@ namespace Chained {
     // ───────────────────────────────────────────────
     void MainMenu::drawButton(const MenuButton& btn)
     {
-        auto& slice = atlas->getSlice(btn.sliceName);
-        glm::vec4 uv = slice.uvRect;
-        uv.y = 1.f - uv.y - uv.w;               // flip Y - this is essential for correct texture rendering
+        if (btn.slice == InvalidSlice) return;
+        const glm::vec4& uv = atlas->getSliceInfo(btn.slice).uvRect; // already flipped for GL
 
         glm::vec3 tint = idleCol;
         if (btn.pressed)       tint = pressedCol;
@@ -201,14 +203,25 @@ namespace Chained {
         ImVec2 exitBtnSize(175, 81);
 
         ImTextureID atlasTexId = (ImTextureID)(intptr_t)atlas->getTexture()->m_id;
+        // A slice missing from the atlas gets a plain text button, like
+        // drawButton skipping it, rather than an out-of-range lookup.
+        auto sliceButton = [&](const char* id, const char* label, SliceHandle slice, const ImVec2& size, const ImVec4& tint) {
+            if (slice == InvalidSlice) {
+                ImGui::PushID(id);
+                bool pressed = ImGui::Button(label, size);
+                ImGui::PopID();
+                return pressed;
+            }
+            const glm::vec4& uv = atlas->getSliceInfo(slice).uvRect;
+            ImVec2 uv0(uv.x, uv.y + uv.w);
+            ImVec2 uv1(uv.x + uv.z, uv.y);
+            return ImGui::ImageButton(id, atlasTexId, size, uv0, uv1, ImVec4(0, 0, 0, 0), tint);
+        };
 
         // ----- PLAY BUTTON -----
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - playBtnSize.x) * 0.5f);
-        auto& playSlice = atlas->getSlice("play_btn");
-        ImVec2 playUv0(playSlice.uvRect.x, 1.0f - playSlice.uvRect.y);
-        ImVec2 playUv1(playSlice.uvRect.x + playSlice.uvRect.z, 1.0f - (playSlice.uvRect.y + playSlice.uvRect.w));
         ImVec4 tint = ImGui::IsItemHovered() ? ImVec4(1,1,0.7f,1) : ImVec4(1,1,1,1);
-        bool playPressed = ImGui::ImageButton("##playbtn", atlasTexId, playBtnSize, playUv0, playUv1, ImVec4(0,0,0,0), tint);
+        bool playPressed = sliceButton("##playbtn", "Play", playBtn.slice, playBtnSize, tint);
 
         // Overlay logic (bright test colors)
         ImVec2 min = ImGui::GetItemRectMin();
@@ -225,10 +238,7 @@ namespace Chained {
 
         // ----- SETTINGS BUTTON -----
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - settingsBtnSize.x) * 0.5f);
-        auto& settingsSlice = atlas->getSlice("settings_btn");
-        ImVec2 settingsUv0(settingsSlice.uvRect.x, 1.0f - settingsSlice.uvRect.y);
-        ImVec2 settingsUv1(settingsSlice.uvRect.x + settingsSlice.uvRect.z, 1.0f - (settingsSlice.uvRect.y + settingsSlice.uvRect.w));
-        bool settingsPressed = ImGui::ImageButton("##settingsbtn", atlasTexId, settingsBtnSize, settingsUv0, settingsUv1);
+        bool settingsPressed = sliceButton("##settingsbtn", "Settings", settingsBtn.slice, settingsBtnSize, ImVec4(1,1,1,1));
 
         min = ImGui::GetItemRectMin();
         max = ImGui::GetItemRectMax();
@@ -242,10 +252,7 @@ namespace Chained {
 
         // ----- EXIT BUTTON -----
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - exitBtnSize.x) * 0.5f);
-        auto& exitSlice = atlas->getSlice("exit_btn");
-        ImVec2 exitUv0(exitSlice.uvRect.x, 1.0f - exitSlice.uvRect.y);
-        ImVec2 exitUv1(exitSlice.uvRect.x + exitSlice.uvRect.z, 1.0f - (exitSlice.uvRect.y + exitSlice.uvRect.w));
-        bool exitPressed = ImGui::ImageButton("##exitbtn", atlasTexId, exitBtnSize, exitUv0, exitUv1);
+        bool exitPressed = sliceButton("##exitbtn", "Exit", exitBtn.slice, exitBtnSize, ImVec4(1,1,1,1));
 
         min = ImGui::GetItemRectMin();
         max = ImGui::GetItemRectMax();
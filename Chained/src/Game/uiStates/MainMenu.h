@@ -11,6 +11,7 @@ namespace Chained {
         const char* sliceName;
         glm::vec2   pos;
         glm::vec2   size;
+        SliceHandle slice = InvalidSlice; // resolved in onEnter
         bool        hovered = false;
         bool        pressed = false;
     };
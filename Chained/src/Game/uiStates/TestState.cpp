@@ -1,4 +1,7 @@
 #include "TestState.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <memory>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -9,44 +12,152 @@ using json = nlohmann::json;
 namespace Chained {
 
     TestState::TestState(const std::string& sceneFile)
+        : sceneFile(sceneFile)
     {
-        loadSceneFromJson(sceneFile);
-        physics = std::make_unique<PhysicsSystem>(b2Vec2(0.0f, 9.8f));
-        physics->addObjects(objects);
+        physics = std::make_unique<PhysicsSystem>(registry, b2Vec2(0.0f, 9.8f));
+        characters = std::make_unique<CharacterController>(registry);
+        tileColliders = std::make_unique<TileColliderBuilder>(registry, *physics);
+        activation = std::make_unique<ActivationSystem>(registry, *physics);
+        characters->setActivation(activation.get());
+        swordName = registry.internName("orc_sword");
     }
 
     void TestState::loadSceneFromJson(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) return;
-
-        json j; file >> j;
-        objects.clear();
-        for (const auto& objJson : j["objects"]) {
-            auto obj = std::make_unique<SceneObject>();
-            obj->name = objJson["name"].get<std::string>();
-            obj->position = { objJson["position"][0].get<float>(), objJson["position"][1].get<float>() };
-            obj->rotation = objJson["rotation"].get<float>();
-            obj->scale = { objJson["scale"][0].get<float>(), objJson["scale"][1].get<float>() };
-            obj->assetId = objJson["assetId"].get<int>();
-            if (objJson.contains("physics")) {
-                const auto& phys = objJson["physics"];
-                obj->physics.enabled = phys.value("enabled", false);
-                obj->physics.bodyType = (Chained::BodyType)phys.value("bodyType", 0);
-                obj->physics.shapeType = (Chained::ShapeType)phys.value("shapeType", 0);
-                obj->physics.gravityScale = phys.value("gravityScale", 1.0f);
-                obj->physics.linearDamping = phys.value("linearDamping", 0.0f);
-                obj->physics.angularDamping = phys.value("angularDamping", 0.0f);
-                obj->physics.fixedRotation = phys.value("fixedRotation", false);
-                obj->physics.isSensor = phys.value("isSensor", false);
-                obj->physics.material.friction = phys.value("friction", 0.5f);
-                obj->physics.material.bounciness = phys.value("bounciness", 0.0f);
-                obj->physics.material.density = phys.value("density", 1.0f);
-                if (phys.contains("size")) {
-                    obj->physics.size = { phys["size"][0].get<float>(), phys["size"][1].get<float>() };
+        streamer.reset();
+        projectiles.clear();
+        tileGrid = TileGrid{};
+        activation->clear(); // re-enables dormant bodies, so before they are destroyed
+        tileColliders->clear();
+        tileMap.clear();
+        animations.reset();
+        animationAtlas.reset();
+        particles.clear();
+        particleAtlases.clear();
+        physics->clear();
+        registry.clear();
+
+        // Entities and bodies are created on this thread as each range of objects
+        // finishes parsing, overlapping CreateBody with the jobs still parsing.
+        SceneLoader::SceneData scene;
+        bool loaded = SceneLoader::loadFile(filename, scene,
+            [this](SceneLoader::ObjectList::iterator first, SceneLoader::ObjectList::iterator last) {
+                for (auto it = first; it != last; ++it) {
+                    physics->addEntity(registry.spawn(**it));
+                }
+            }, jobs);
+        if (!loaded) {
+            physics->clear();
+            registry.clear();
+            camera = std::make_unique<Camera>(1280.0f, 720.0f);
+            return;
+        }
+
+        const json& j = scene.document;
+        // Optional rooms that never touch each other, stepped in parallel:
+        // "partitions": [{ "min": [x, y], "max": [x, y] }, ...]
+        if (j.contains("partitions")) {
+            for (const auto& region : j["partitions"]) {
+                physics->addPartition({ region["min"][0].get<float>(), region["min"][1].get<float>() },
+                                      { region["max"][0].get<float>(), region["max"][1].get<float>() });
+            }
+        }
+
+        // Walls are static boxes; fold touching ones into chain outlines.
+        physics->mergeStaticColliders();
+
+        // Optional collision grid, in DebugEditorState's tile ids, rows bottom-up:
+        // "tileGrid": { "origin": [x, y], "tileSize": 32, "width": w, "height": h,
+        //               "tiles": [...], "solid": [1, 2] }
+        // With one, the sword leaves Box2D and walks the grid as a character.
+        if (j.contains("tileGrid")) {
+            const json& grid = j["tileGrid"];
+            tileGrid.resize(grid.value("width", 0), grid.value("height", 0));
+            tileGrid.tileSize = grid.value("tileSize", 32.0f);
+            if (grid.contains("origin")) {
+                tileGrid.origin = { grid["origin"][0].get<float>(), grid["origin"][1].get<float>() };
+            }
+            std::vector<int> tiles = grid.value("tiles", std::vector<int>());
+            std::vector<int> solidIds = grid.value("solid", std::vector<int>{ 1, 2 });
+            if (tiles.size() != tileGrid.solid.size()) {
+                std::cerr << "[ERROR] tileGrid has " << tiles.size() << " tiles, expected "
+                          << tileGrid.solid.size() << std::endl;
+                tiles.assign(tileGrid.solid.size(), 0);
+            }
+            for (size_t i = 0; i < tiles.size(); ++i) {
+                tileGrid.solid[i] = std::find(solidIds.begin(), solidIds.end(), tiles[i]) != solidIds.end();
+            }
+
+            for (size_t i = 0; i < registry.nameIds.size(); ++i) {
+                if (registry.nameIds.data()[i].id != swordName) continue;
+                Entity sword = registry.nameIds.owner(i);
+                const Collider* collider = registry.colliders.get(sword);
+                const Transform* transform = registry.transforms.get(sword);
+                if (!collider || !transform) continue;
+                physics->removeEntity(sword);
+                CharacterBody body;
+                body.halfExtents = 0.5f * collider->desc.size * transform->scale;
+                registry.characters.add(sword, body);
+            }
+        }
+
+        // Optional painted tile map (a TileMap file from the tile editor) whose
+        // solid tiles become a few static boxes per chunk:
+        // "tileMap": { "file": "room.tilemap", "origin": [x, y], "tileSize": 32, "solid": [1, 2] }
+        if (j.contains("tileMap")) {
+            const json& tiles = j["tileMap"];
+            if (tileMap.load(tiles.value("file", std::string()))) {
+                tileColliders->settings.tileSize = tiles.value("tileSize", 32.0f);
+                if (tiles.contains("origin")) {
+                    tileColliders->settings.origin = { tiles["origin"][0].get<float>(), tiles["origin"][1].get<float>() };
+                }
+                for (int id : tiles.value("solid", std::vector<int>{ 1, 2 })) {
+                    tileColliders->setSolid(TileId(id), true);
                 }
-                obj->physics.radius = phys.value("radius", 0.5f);
+                tileColliders->sync(tileMap);
+                std::cout << "[INFO] Tile map: " << tileMap.getChunkCount() << " chunks, "
+                          << tileColliders->getFixtureCount() << " collider boxes" << std::endl;
+            }
+            else {
+                std::cerr << "[ERROR] Could not load tile map for scene: " << filename << std::endl;
+            }
+        }
+
+        // Optional animated sprites from an Aseprite sheet, played by clip
+        // (frameTag) name; a "grid" spawns columns x rows copies:
+        // "animated": { "atlas": "assets/textures/fire asset.json",
+        //               "entities": [{ "clip": "", "position": [x, y], "scale": [1, 1], "speed": 1,
+        //                              "grid": { "columns": 10, "rows": 10, "spacing": [64, 64] } }] }
+        if (j.contains("animated")) {
+            const json& animated = j["animated"];
+            std::string atlasFile = animated.value("atlas", std::string());
+            if (std::ifstream(atlasFile).good()) {
+                animationAtlas = std::make_unique<SpriteAtlas>(atlasFile, jobs);
+                animations = std::make_unique<AnimationSystem>(registry, *animationAtlas);
+                animations->setActivation(activation.get());
+                spawnAnimated(animated.value("entities", json::array()));
+            }
+            else {
+                std::cerr << "[ERROR] Animation atlas not found: " << atlasFile << std::endl;
+            }
+        }
+
+        // Optional particle emitters drawn from an atlas's frames; angles are
+        // radians, curves are [t, ...] keys over each particle's life:
+        // "particles": [{ "atlas": "assets/textures/fire asset.json", "clip": "",
+        //                 "position": [x, y], "area": [w, h], "rate": 2000, "burst": 0,
+        //                 "lifetime": [0.6, 1.2], "speed": [40, 120], "direction": 1.57,
+        //                 "spread": 0.8, "spin": [0, 0], "gravity": [0, 60], "drag": 0.5,
+        //                 "frameRate": 0, "size": [[0, 0.5], [1, 1.5]],
+        //                 "color": [[0, 1, 1, 1, 1], [1, 1, 0.3, 0, 0]] }]
+        if (j.contains("particles")) {
+            addEmitters(j["particles"]);
+        }
+
+        if (j.contains("world")) {
+            streamer = std::make_unique<WorldStreamer>(registry, *physics, *jobs);
+            if (!streamer->open(j["world"])) {
+                streamer.reset();
             }
-            objects.push_back(std::move(obj));
         }
 
         if (j.contains("camera")) {
@@ -60,33 +171,115 @@ namespace Chained {
         else {
             camera = std::make_unique<Camera>(1280.0f, 720.0f);
         }
+
+        // The swords are driven by input, so they stay out of tiering and
+        // the camera, which tiering and streaming centre on, follows one.
+        player = NullEntity;
+        for (size_t i = 0; i < registry.nameIds.size(); ++i) {
+            if (registry.nameIds.data()[i].id != swordName) continue;
+            player = registry.nameIds.owner(i);
+            break;
+        }
+        followPlayer();
+
+        // Streamed chunks are not tiered; the streamer already bounds them.
+        activation->rebuild(*camera);
+        for (size_t i = 0; i < registry.nameIds.size(); ++i) {
+            if (registry.nameIds.data()[i].id == swordName) activation->keepActive(registry.nameIds.owner(i));
+        }
+    }
+
+    void TestState::followPlayer() {
+        const Transform* transform = registry.transforms.get(player);
+        if (!transform) return;
+        glm::vec2 viewSize = glm::vec2(camera->getViewportWidth(), camera->getViewportHeight()) / camera->getZoom();
+        camera->setPostion(transform->position - 0.5f * viewSize);
     }
 
     void TestState::onEnter() {
         auto& rm = *ResourceManager::get();
-        atlas = std::make_unique<SpriteAtlas>("assets/textures/sprites.json");
-        shader = rm.loadShader("sprite.vert", "sprite.frag", nullptr, "sprite");
-        renderer = std::make_shared<SpriteRenderer>(shader);
-        shader->use();
-        shader->setUniform("projection", camera->getProjectionMatrix());
-        shader->setUniform("image", 0);
+        // The atlas comes first: polygon colliders are built from its slice shapes.
+        atlas = std::make_unique<SpriteAtlas>("assets/textures/sprites.json", jobs);
+        registry.bindAtlas(atlas.get());
+        loadSceneFromJson(sceneFile);
+        shader = rm.loadShader("sprite_batch.vert", "sprite_batch.frag", nullptr, "sprite_batch");
+        batch = std::make_unique<SpriteBatch>(shader);
+        batch->setJobSystem(jobs);
+        lineShader = rm.loadShader("debug_line.vert", "debug_line.frag", nullptr, "debug_line");
+        lineBatch = std::make_unique<LineBatch>(lineShader);
     }
 
     void TestState::onExit() {}
 
     void TestState::update(float dt) {
+        // Frame boundary: publish the step that ran during the last frame.
+        // Until beginStep below the world is idle and safe to touch.
+        physics->finishStep();
+        physics->migrateMovedBodies();
+        // Rebuilds only chunks whose tiles changed; nothing when none did.
+        tileColliders->sync(tileMap);
+
+        // F5 saves the physics state, F9 rolls back to it (instant restart).
+        bool saveKey = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+        bool restoreKey = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+        if (saveKey && !saveKeyDown) {
+            physics->saveSnapshot(snapshot);
+            std::cout << "[INFO] Physics snapshot: " << physics->getMovingBodyCount() << " moving bodies, "
+                      << snapshot.size() << " bytes, saved in " << physics->getLastSaveMicros() << " us" << std::endl;
+        }
+        if (restoreKey && !restoreKeyDown && !snapshot.empty()) {
+            physics->restoreSnapshot(snapshot);
+            std::cout << "[INFO] Physics snapshot restored in " << physics->getLastRestoreMicros() << " us" << std::endl;
+        }
+        saveKeyDown = saveKey;
+        restoreKeyDown = restoreKey;
+
+        // F6 reports how many pairs reach the narrowphase, to compare filters.
+        bool statsKey = glfwGetKey(window, GLFW_KEY_F6) == GLFW_PRESS;
+        if (statsKey && !statsKeyDown) {
+            ContactStats stats = physics->getContactStats();
+            std::cout << "[INFO] Physics contacts: " << stats.pairs << " pairs, " << stats.touching
+                      << " touching, " << registry.bodies.size() << " bodies" << std::endl;
+            std::cout << "[INFO] Activation: " << activation->getActiveCount() << " active, "
+                      << activation->getReducedCount() << " reduced, " << activation->getDormantCount()
+                      << " dormant" << std::endl;
+            std::cout << "[INFO] Particles: " << particles.size() << " live in "
+                      << particles.getEmitterCount() << " emitters" << std::endl;
+        }
+        statsKeyDown = statsKey;
+
+        bool collidersKey = glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS;
+        if (collidersKey && !collidersKeyDown) showColliders = !showColliders;
+        collidersKeyDown = collidersKey;
+
+        followPlayer();
+        if (streamer) {
+            streamer->update(*camera, dt);
+        }
+        activation->update(*camera);
+
+        // WASD in world axes (y is up), shared by the characters and the sword.
+        glm::vec2 input(0.0f);
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) input.y += 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) input.y -= 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) input.x -= 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) input.x += 1.0f;
+
+        if (registry.characters.size() > 0) {
+            for (CharacterBody& body : registry.characters) {
+                body.velocity = 320.0f * input;
+            }
+            characters->update(dt, tileGrid, jobs);
+        }
+
         // Apply movement with forces for better pushing
-        for (auto& obj : objects) {
-            if (obj->name == "orc_sword") {
-                b2Body* body = physics->getBodyFor(obj.get());
+        for (size_t i = 0; i < registry.nameIds.size(); ++i) {
+            if (registry.nameIds.data()[i].id == swordName) {
+                b2Body* body = physics->getBodyFor(registry.nameIds.owner(i));
                 if (body) {
-                    b2Vec2 vel(0, 0);
                     float speed = 10.0f; // Faster speed for better pushing
-                    if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_W) == GLFW_PRESS) vel.y = -speed;
-                    if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_S) == GLFW_PRESS) vel.y = speed;
-                    if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_A) == GLFW_PRESS) vel.x = -speed;
-                    if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_D) == GLFW_PRESS) vel.x = speed;
-                    body->SetLinearVelocity(vel);
+                    b2Vec2 vel(speed * input.x, speed * input.y);
+                    physics->queueLinearVelocity(registry.nameIds.owner(i), vel);
                     
                     // Debug: Print velocity and mass
                     static int frameCount = 0;
@@ -98,69 +291,303 @@ namespace Chained {
             }
         }
 
-        physics->step(dt);
-        physics->syncToObjects(objects);
-        
+        fireProjectiles(dt);
+        projectiles.update(dt, *physics, jobs);
+        for (const ProjectileHit& hit : projectiles.getHits()) {
+            // Knock whatever was hit along the projectile's path.
+            glm::vec2 push = glm::normalize(hit.velocity) * 0.5f;
+            physics->queueImpulse(hit.target, b2Vec2(push.x, push.y));
+        }
+
+        if (animations) {
+            glm::vec2 viewMin = camera->getPosition();
+            glm::vec2 viewMax = viewMin + glm::vec2(camera->getViewportWidth(), camera->getViewportHeight()) / camera->getZoom();
+            animations->advance(dt);
+            animations->update(viewMin, viewMax, jobs);
+        }
+        particles.update(dt, jobs);
+
+        // Steps on the job system while this frame renders the poses
+        // published above.
+        physics->beginStep(dt, jobs);
+
         // No more manual AABB collision detection - Box2D handles it automatically!
     }
 
     void TestState::render() {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // Same commands as on the render thread, just executed immediately.
+        framePacket.reset();
+        record(framePacket);
+        framePacket.execute();
+    }
+
+    void TestState::record(FramePacket& packet) {
         auto tex = atlas->getTexture();
         if (!tex) return;
-        int texW = tex->m_width, texH = tex->m_height;
-        for (const auto& obj : objects) {
-            if (obj->assetId < 0 || obj->assetId >= static_cast<int>(atlas->getAllSlices().size())) continue;
-
-            const auto& asset = atlas->getSlice(obj->name);
-            glm::vec2 size = { asset.uvRect.z * texW * obj->scale.x, asset.uvRect.w * texH * obj->scale.y };
-            glm::vec4 uv = asset.uvRect;
-            uv.y = 1.0f - uv.y - uv.w;
-            renderer->DrawSprite(tex, obj->position, size, obj->rotation, glm::vec3(1.0f), uv);
-        }
-        
-        // Debug: Draw physics collision shapes
-        for (const auto& obj : objects) {
-            if (!obj->physics.enabled) continue;
-            
-            b2Body* body = physics->getBodyFor(obj.get());
-            if (!body) continue;
-            
-            // Get body position and transform
-            b2Vec2 pos = body->GetPosition();
-            float angle = body->GetAngle();
-            
-            // Convert from Box2D meters to screen pixels
-            glm::vec2 screenPos = { pos.x * PhysicsSystem::PHYSICS_SCALE, pos.y * PhysicsSystem::PHYSICS_SCALE };
-            
-            if (obj->physics.shapeType == ShapeType::Box) {
-                // Draw box collision shape
-                glm::vec2 size = obj->physics.size * obj->scale;
-                glm::vec2 halfSize = size * 0.5f;
-                
-                // Calculate corners in local space
-                glm::vec2 corners[4] = {
-                    {-halfSize.x, -halfSize.y},
-                    {+halfSize.x, -halfSize.y},
-                    {+halfSize.x, +halfSize.y},
-                    {-halfSize.x, +halfSize.y}
-                };
-                
-                // Transform corners to world space
-                float c = cos(angle), s = sin(angle);
-                glm::vec2 worldCorners[4];
-                for (int i = 0; i < 4; ++i) {
-                    worldCorners[i].x = screenPos.x + (corners[i].x * c - corners[i].y * s);
-                    worldCorners[i].y = screenPos.y + (corners[i].x * s + corners[i].y * c);
+        packet.addCommand([]() {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        });
+
+        // Cull in parallel into a flag per sprite, then submit in pool order.
+        glm::vec2 viewMin = camera->getPosition();
+        glm::vec2 viewMax = viewMin + glm::vec2(camera->getViewportWidth(), camera->getViewportHeight()) / camera->getZoom();
+        const size_t spriteCount = registry.sprites.size();
+        visibleSprites.assign(spriteCount, 0);
+        auto cullRange = [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const Sprite& sprite = registry.sprites.data()[i];
+                if (sprite.slice == InvalidSlice || sprite.baked) continue; // baked: drawn by the streamer
+                const Transform* transform = registry.transforms.get(registry.sprites.owner(i));
+                if (!transform) continue;
+
+                glm::vec2 half = 0.5f * atlas->getSliceInfo(sprite.slice).pixelSize * transform->scale;
+                glm::vec2 center = transform->position + half;
+                if (transform->rotation != 0.0f) {
+                    half = glm::vec2(glm::length(half)); // any rotation fits in this circle
+                }
+                visibleSprites[i] = center.x + half.x >= viewMin.x && center.x - half.x <= viewMax.x &&
+                                    center.y + half.y >= viewMin.y && center.y - half.y <= viewMax.y;
+            }
+        };
+        if (jobs && spriteCount >= CULL_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(spriteCount, CULL_GRAIN, cullRange));
+        }
+        else {
+            cullRange(0, spriteCount);
+        }
+
+        packet.beginSprites(batch.get(), camera->getProjectionMatrix());
+        for (size_t i = 0; i < spriteCount; ++i) {
+            if (!visibleSprites[i]) continue;
+            const Sprite& sprite = registry.sprites.data()[i];
+            const Transform* transform = registry.transforms.get(registry.sprites.owner(i));
+            const SliceInfo& slice = atlas->getSliceInfo(sprite.slice);
+            packet.drawSprite(tex, transform->position, slice.pixelSize, transform->rotation, glm::vec3(1.0f), slice.uvRect, transform->scale);
+        }
+        if (streamer) {
+            streamer->record(packet, tex, viewMin, viewMax);
+        }
+        if (animations) {
+            // Culled and evaluated by the animation update.
+            auto animTex = animationAtlas->getTexture();
+            for (size_t i = 0; i < registry.animators.size(); ++i) {
+                if (!animations->isVisible(i)) continue;
+                const Transform* transform = registry.transforms.get(registry.animators.owner(i));
+                const SliceInfo& frame = animationAtlas->getFrameInfo(registry.animators.data()[i].frame);
+                packet.drawSprite(animTex, transform->position, frame.pixelSize, transform->rotation, glm::vec3(1.0f), frame.uvRect, transform->scale);
+            }
+        }
+        particles.record(packet, viewMin, viewMax, jobs);
+        packet.endSprites();
+
+        if (projectiles.size() > 0) {
+            LineList& lines = packet.beginLines(lineBatch.get(), camera->getProjectionMatrix());
+            const uint32_t color = packColor(glm::vec3(1.0f, 0.9f, 0.2f));
+            for (size_t i = 0; i < projectiles.size(); ++i) {
+                lines.cross(projectiles.getPosition(i), 2.0f + projectiles.getRadius(i), color);
+            }
+        }
+
+        if (showColliders) {
+            recordColliders(packet.beginLines(lineBatch.get(), camera->getProjectionMatrix()));
+        }
+    }
+
+    void TestState::spawnAnimated(const json& entities) {
+        for (const auto& desc : entities) {
+            ClipHandle clip = animations->findClip(desc.value("clip", std::string()));
+            if (clip == InvalidClip) {
+                std::cerr << "[ERROR] Unknown animation clip: " << desc.value("clip", std::string()) << std::endl;
+                continue;
+            }
+            glm::vec2 position(0.0f), scale(1.0f), spacing(64.0f);
+            if (desc.contains("position")) position = { desc["position"][0].get<float>(), desc["position"][1].get<float>() };
+            if (desc.contains("scale")) scale = { desc["scale"][0].get<float>(), desc["scale"][1].get<float>() };
+            int columns = 1, rows = 1;
+            if (desc.contains("grid")) {
+                const json& grid = desc["grid"];
+                columns = std::max(1, grid.value("columns", 1));
+                rows = std::max(1, grid.value("rows", 1));
+                if (grid.contains("spacing")) spacing = { grid["spacing"][0].get<float>(), grid["spacing"][1].get<float>() };
+            }
+            float speed = desc.value("speed", 1.0f);
+            for (int y = 0; y < rows; ++y) {
+                for (int x = 0; x < columns; ++x) {
+                    Entity e = registry.create();
+                    registry.transforms.add(e, { position + glm::vec2(x, y) * spacing, 0.0f, scale });
+                    animations->play(e, clip, speed);
+                    // Offset start times so copies do not flicker in lockstep.
+                    registry.animators.get(e)->startTime -= 0.037 * (y * columns + x);
                 }
-                
-                // Draw collision box outline (red)
-                for (int i = 0; i < 4; ++i) {
-                    // Simple line drawing - you might want to use your debug drawing system
-                    // DrawDebugLine(worldCorners[i], worldCorners[(i + 1) % 4], glm::vec3(1, 0, 0));
+            }
+        }
+    }
+
+    void TestState::addEmitters(const json& emitters) {
+        auto range = [](const json& desc, const char* key, glm::vec2 fallback) {
+            if (!desc.contains(key)) return fallback;
+            return glm::vec2(desc[key][0].get<float>(), desc[key][1].get<float>());
+        };
+        auto curve = [](const json& desc, const char* key) {
+            ParticleCurve keys;
+            for (const auto& k : desc.value(key, json::array())) {
+                ParticleKey point;
+                point.t = k[0].get<float>();
+                for (size_t c = 1; c < k.size() && c <= 4; ++c) point.value[int(c - 1)] = k[c].get<float>();
+                keys.push_back(point);
+            }
+            std::sort(keys.begin(), keys.end(), [](const ParticleKey& a, const ParticleKey& b) { return a.t < b.t; });
+            return keys;
+        };
+
+        for (const auto& desc : emitters) {
+            std::string atlasFile = desc.value("atlas", std::string());
+            auto& emitterAtlas = particleAtlases[atlasFile];
+            if (!emitterAtlas) {
+                if (!std::ifstream(atlasFile).good()) {
+                    std::cerr << "[ERROR] Particle atlas not found: " << atlasFile << std::endl;
+                    particleAtlases.erase(atlasFile);
+                    continue;
                 }
+                emitterAtlas = std::make_unique<SpriteAtlas>(atlasFile, jobs);
             }
+
+            ParticleEmitterDesc emitter;
+            emitter.position = range(desc, "position", emitter.position);
+            emitter.area = range(desc, "area", emitter.area);
+            emitter.rate = desc.value("rate", emitter.rate);
+            emitter.burst = desc.value("burst", emitter.burst);
+            emitter.capacity = desc.value("capacity", emitter.capacity);
+            emitter.lifetime = range(desc, "lifetime", emitter.lifetime);
+            emitter.speed = range(desc, "speed", emitter.speed);
+            emitter.direction = desc.value("direction", emitter.direction);
+            emitter.spread = desc.value("spread", emitter.spread);
+            emitter.spin = range(desc, "spin", emitter.spin);
+            emitter.gravity = range(desc, "gravity", emitter.gravity);
+            emitter.drag = desc.value("drag", emitter.drag);
+            emitter.size = curve(desc, "size");
+            emitter.color = curve(desc, "color");
+            emitter.clip = desc.value("clip", emitter.clip);
+            emitter.frameRate = desc.value("frameRate", emitter.frameRate);
+            particles.addEmitter(emitter, *emitterAtlas);
+        }
+        std::cout << "[INFO] Particle emitters: " << particles.getEmitterCount() << std::endl;
+    }
+
+    void TestState::fireProjectiles(float dt) {
+        // Holding space fires rings of projectiles from the sword.
+        fireCooldown -= dt;
+        if (glfwGetKey(window, GLFW_KEY_SPACE) != GLFW_PRESS || fireCooldown > 0.0f) return;
+        fireCooldown = 0.05f;
+
+        for (size_t i = 0; i < registry.nameIds.size(); ++i) {
+            if (registry.nameIds.data()[i].id != swordName) continue;
+            Entity owner = registry.nameIds.owner(i);
+            const Transform* transform = registry.transforms.get(owner);
+            if (!transform) continue;
+
+            const int ringSize = 64;
+            const float speed = 400.0f;
+            ProjectileDesc desc;
+            desc.position = transform->position;
+            desc.radius = 2.0f;
+            desc.filter.ignore = owner;
+            for (int k = 0; k < ringSize; ++k) {
+                float angle = fireAngle + 6.28318530718f * k / ringSize;
+                desc.velocity = speed * glm::vec2(std::cos(angle), std::sin(angle));
+                if (!projectiles.spawn(desc)) return;
+            }
+            fireAngle += 0.1f;
+        }
+    }
+
+    void TestState::recordColliders(LineList& lines) {
+        // Culled against the same view as the sprites; rotation is covered by
+        // testing the collider's bounding circle.
+        glm::vec2 viewMin = camera->getPosition();
+        glm::vec2 viewMax = viewMin + glm::vec2(camera->getViewportWidth(), camera->getViewportHeight()) / camera->getZoom();
+        const uint32_t boxColor = packColor(glm::vec3(1.0f, 0.0f, 0.0f));
+        const uint32_t circleColor = packColor(glm::vec3(0.0f, 1.0f, 0.0f));
+        const uint32_t polygonColor = packColor(glm::vec3(1.0f, 0.5f, 0.0f));
+
+        for (size_t i = 0; i < registry.bodies.size(); ++i) {
+            Entity e = registry.bodies.owner(i);
+            const Collider* collider = registry.colliders.get(e);
+            const Transform* transform = registry.transforms.get(e);
+            if (!collider || !transform) continue;
+
+            // Read the published pose, not the body: the world may be mid-step.
+            glm::vec2 center = transform->position;
+            const PhysicsBody& desc = collider->desc;
+            float reach = desc.shapeType == ShapeType::Circle
+                ? desc.radius
+                : 0.5f * glm::length(desc.size * transform->scale);
+            if (center.x + reach < viewMin.x || center.x - reach > viewMax.x ||
+                center.y + reach < viewMin.y || center.y - reach > viewMax.y) {
+                continue;
+            }
+
+            if (desc.shapeType == ShapeType::Box) {
+                lines.box(center, 0.5f * desc.size * transform->scale, transform->rotation, boxColor);
+            }
+            else if (desc.shapeType == ShapeType::Circle) {
+                lines.circle(center, desc.radius, circleColor);
+            }
+            else if (desc.shapeType == ShapeType::Polygon) {
+                const Sprite* sprite = registry.sprites.get(e);
+                if (!sprite || sprite->slice == InvalidSlice) continue;
+                const SliceShape& shape = atlas->getSliceShape(sprite->slice);
+                if (shape.pieces.empty()) {
+                    lines.box(center, 0.5f * desc.size * transform->scale, transform->rotation, boxColor);
+                    continue;
+                }
+                // Same stretch and rotation as the fixtures.
+                glm::vec2 stretch = desc.size / shape.size;
+                float c = std::cos(transform->rotation), s = std::sin(transform->rotation);
+                glm::vec2 points[MaxPieceVertices];
+                for (const auto& piece : shape.pieces) {
+                    for (size_t k = 0; k < piece.size(); ++k) {
+                        glm::vec2 p = piece[k] * stretch;
+                        points[k] = center + glm::vec2(c * p.x - s * p.y, s * p.x + c * p.y);
+                    }
+                    lines.polygon(points, piece.size(), polygonColor);
+                }
+            }
+        }
+
+        const uint32_t outlineColor = packColor(glm::vec3(0.2f, 0.6f, 1.0f));
+        for (const auto& loop : physics->getMergedOutlines()) {
+            lines.polygon(loop.data(), loop.size(), outlineColor);
+        }
+
+        const uint32_t tileBoxColor = packColor(glm::vec3(0.8f, 0.3f, 1.0f));
+        tileRects.clear();
+        tileColliders->collectRects(tileRects);
+        for (const MergeRect& rect : tileRects) {
+            if (rect.max.x < viewMin.x || rect.min.x > viewMax.x || rect.max.y < viewMin.y || rect.min.y > viewMax.y) continue;
+            lines.box(0.5f * (rect.min + rect.max), 0.5f * (rect.max - rect.min), 0.0f, tileBoxColor);
+        }
+
+        // Solid tiles in view, and the characters walking them.
+        const uint32_t tileColor = packColor(glm::vec3(0.6f, 0.6f, 0.6f));
+        if (tileGrid.width > 0 && tileGrid.tileSize > 0.0f) {
+            const float size = tileGrid.tileSize;
+            glm::ivec2 lo = glm::max(glm::ivec2(glm::floor((viewMin - tileGrid.origin) / size)), glm::ivec2(0));
+            glm::ivec2 hi = glm::min(glm::ivec2(glm::floor((viewMax - tileGrid.origin) / size)),
+                                     glm::ivec2(tileGrid.width - 1, tileGrid.height - 1));
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    if (!tileGrid.isSolid(x, y)) continue;
+                    lines.box(tileGrid.origin + (glm::vec2(x, y) + 0.5f) * size, glm::vec2(0.5f * size), 0.0f, tileColor);
+                }
+            }
+        }
+        for (size_t i = 0; i < registry.characters.size(); ++i) {
+            const Transform* transform = registry.transforms.get(registry.characters.owner(i));
+            if (!transform) continue;
+            const CharacterBody& body = registry.characters.data()[i];
+            lines.box(transform->position, body.halfExtents, 0.0f, body.grounded ? circleColor : boxColor);
         }
     }
 
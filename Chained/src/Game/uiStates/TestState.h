@@ -3,16 +3,28 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include "../../headers/GameState.h"
 #include "../../headers/SpriteAtlas.h"
 #include "../../headers/SpriteRenderer.h"
+#include "../../headers/SpriteBatch.h"
 #include "../../headers/ResourceManager.h"
 #include "../../headers/Camera.h"
 #include "../../headers/types.h"
 #include "../../headers/physics.h"
+#include "../../headers/SceneLoader.h"
+#include "../../headers/WorldStreamer.h"
+#include "../../headers/FramePacket.h"
+#include "../../headers/LineBatch.h"
+#include "../../headers/ProjectileSystem.h"
+#include "../../headers/ActivationSystem.h"
+#include "../../headers/CharacterController.h"
+#include "../../headers/TileColliders.h"
+#include "../../headers/AnimationSystem.h"
+#include "../../headers/ParticleSystem.h"
 
 namespace Chained {
 
@@ -25,16 +37,58 @@ namespace Chained {
         void update(float dt) override;
         void render() override;
 
+        bool supportsFramePackets() const override { return true; }
+        void record(FramePacket& packet) override;
+
     private:
         void loadSceneFromJson(const std::string& filename);
+        void recordColliders(LineList& lines);
+        void fireProjectiles(float dt);
+        void spawnAnimated(const nlohmann::json& entities);
+        void addEmitters(const nlohmann::json& emitters);
+        void followPlayer();
+
+        static constexpr size_t CULL_GRAIN = 1024;
 
-        std::vector<std::unique_ptr<SceneObject>> objects;
+        std::string sceneFile; // loaded in onEnter, once the job system is attached
+
+        Registry registry; // declared before physics and streamer, which hold references to it
+        StringId swordName = InvalidStringId;
+        Entity player = NullEntity; // the first sword; the camera follows it
         std::unique_ptr<Camera> camera;
         std::unique_ptr<SpriteAtlas> atlas;
-        std::shared_ptr<SpriteRenderer> renderer;
+        std::unique_ptr<SpriteBatch> batch;
+        std::vector<uint8_t> visibleSprites;
+        FramePacket framePacket; // used by render() when there is no render thread
         std::shared_ptr<Shader> shader;
+        std::unique_ptr<LineBatch> lineBatch;
+        std::shared_ptr<Shader> lineShader;
+        bool showColliders = false; // F2
+        bool collidersKeyDown = false;
 
         std::unique_ptr<PhysicsSystem> physics;
+        std::unique_ptr<WorldStreamer> streamer; // only for chunked world manifests
+        std::unique_ptr<ActivationSystem> activation;
+        std::unique_ptr<CharacterController> characters; // for entities moved on tileGrid
+        TileGrid tileGrid;
+        TileMap tileMap;
+        std::unique_ptr<TileColliderBuilder> tileColliders;
+        std::vector<MergeRect> tileRects; // debug drawing scratch
+
+        std::unique_ptr<SpriteAtlas> animationAtlas; // only for scenes with "animated"
+        std::unique_ptr<AnimationSystem> animations;
+
+        ParticleSystem particles;
+        std::unordered_map<std::string, std::unique_ptr<SpriteAtlas>> particleAtlases; // by file, shared by emitters
+
+        ProjectileSystem projectiles;
+        float fireCooldown = 0.0f;
+        float fireAngle = 0.0f; // spins the ring so patterns interleave
+
+        PhysicsSnapshot snapshot;
+        bool saveKeyDown = false;
+        bool restoreKeyDown = false;
+        bool statsKeyDown = false;
     };
 
 }
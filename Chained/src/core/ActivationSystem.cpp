@@ -0,0 +1,272 @@
+#include "../headers/ActivationSystem.h"
+#include "../headers/Camera.h"
+#include "../headers/physics.h"
+#include <cmath>
+
+namespace Chained {
+
+    namespace {
+        glm::vec2 viewCenter(const Camera& camera) {
+            glm::vec2 viewSize = { camera.getViewportWidth() / camera.getZoom(), camera.getViewportHeight() / camera.getZoom() };
+            return camera.getPosition() + 0.5f * viewSize;
+        }
+    }
+
+    ActivationSystem::ActivationSystem(Registry& registry, PhysicsSystem& physics)
+        : registry(registry), physics(physics) {
+    }
+
+    glm::ivec2 ActivationSystem::cellOf(const glm::vec2& position) const {
+        return glm::ivec2(int(std::floor(position.x / settings.cellSize)), int(std::floor(position.y / settings.cellSize)));
+    }
+
+    bool ActivationSystem::isManaged(Entity e) const {
+        return e.index < owners.size() && owners[e.index] == e && tiers[e.index] <= uint8_t(Tier::Dormant);
+    }
+
+    bool ActivationSystem::isSimulated(Entity e) const {
+        const Collider* collider = registry.colliders.get(e);
+        return collider && collider->desc.enabled && collider->desc.bodyType != BodyType::Static;
+    }
+
+    ActivationSystem::Tier ActivationSystem::tierOf(Entity e) const {
+        return isManaged(e) ? static_cast<Tier>(tiers[e.index]) : Tier::Active;
+    }
+
+    bool ActivationSystem::shouldTick(Entity e) const {
+        switch (tierOf(e)) {
+        case Tier::Active: return true;
+        case Tier::Reduced: return (frame + e.index) % settings.reducedInterval == 0;
+        default: return false;
+        }
+    }
+
+    float ActivationSystem::getTickDt(Entity e, float dt) const {
+        switch (tierOf(e)) {
+        case Tier::Active: return dt;
+        case Tier::Reduced: return dt * float(settings.reducedInterval);
+        default: return 0.0f;
+        }
+    }
+
+    void ActivationSystem::setTier(Entity e, uint8_t tier) {
+        if (owners.size() <= e.index) {
+            owners.resize(e.index + 1, NullEntity);
+            tiers.resize(e.index + 1, Unmanaged);
+            awakeSlot.resize(e.index + 1, NoSlot);
+        }
+        // A reused index still counts against the tier its old owner had.
+        uint8_t old = tiers[e.index];
+        if (old == uint8_t(Tier::Active)) --activeCount;
+        else if (old == uint8_t(Tier::Dormant)) --dormantCount;
+
+        owners[e.index] = e;
+        tiers[e.index] = tier;
+        if (tier == uint8_t(Tier::Active)) ++activeCount;
+        else if (tier == uint8_t(Tier::Dormant)) ++dormantCount;
+    }
+
+    void ActivationSystem::wake(Entity e, Tier tier) {
+        bool wasDormant = isManaged(e) && tiers[e.index] == uint8_t(Tier::Dormant);
+        setTier(e, uint8_t(tier));
+        if (awakeSlot[e.index] == NoSlot) {
+            awakeSlot[e.index] = static_cast<uint32_t>(awake.size());
+            awake.push_back(e);
+        }
+        if (wasDormant && isSimulated(e)) physics.setBodyEnabled(e, true);
+    }
+
+    void ActivationSystem::sleep(Entity e, const glm::vec2& position) {
+        setTier(e, uint8_t(Tier::Dormant));
+        uint32_t slot = awakeSlot[e.index];
+        if (slot != NoSlot) {
+            awakeSlot[e.index] = NoSlot;
+            if (slot + 1 != awake.size()) {
+                awake[slot] = awake.back();
+                awakeSlot[awake[slot].index] = slot;
+            }
+            awake.pop_back();
+        }
+        if (isSimulated(e)) physics.setBodyEnabled(e, false);
+        glm::ivec2 cell = cellOf(position);
+        dormantCells[keyFor(cell.x, cell.y)].push_back(e);
+    }
+
+    void ActivationSystem::forget(Entity e) {
+        if (e.index >= owners.size() || owners[e.index] != e) return;
+        uint32_t slot = awakeSlot[e.index];
+        if (slot != NoSlot) {
+            awakeSlot[e.index] = NoSlot;
+            if (slot + 1 != awake.size()) {
+                awake[slot] = awake.back();
+                awakeSlot[awake[slot].index] = slot;
+            }
+            awake.pop_back();
+        }
+        setTier(e, Unmanaged);
+    }
+
+    bool ActivationSystem::keepInCell(Entity e, const glm::ivec2& cell) {
+        const Transform* transform = registry.alive(e) ? registry.transforms.get(e) : nullptr;
+        if (!transform) {
+            forget(e);
+            return false;
+        }
+        // Woken or re-added since this entry was made.
+        if (!isManaged(e) || tiers[e.index] != uint8_t(Tier::Dormant)) return false;
+        // Still dormant but moved (teleport, snapshot restore, script):
+        // file it under its new cell so the wake pass can find it there.
+        if (cellOf(transform->position) != cell) {
+            moved.push_back(e);
+            return false;
+        }
+        return true;
+    }
+
+    void ActivationSystem::place(Entity e, const glm::vec2& position) {
+        float distance = glm::length(position - center);
+        if (distance < settings.activeRadius) wake(e, Tier::Active);
+        else if (distance < settings.reducedRadius) wake(e, Tier::Reduced);
+        else sleep(e, position);
+    }
+
+    void ActivationSystem::add(Entity e) {
+        const Transform* transform = registry.transforms.get(e);
+        if (!transform) return;
+        if (e.index < owners.size() && owners[e.index] == e && tiers[e.index] == Pinned) return;
+        // Re-adding a dormant entity files it again; the old entry is
+        // dropped when its cell is next visited.
+        place(e, transform->position);
+    }
+
+    void ActivationSystem::keepActive(Entity e) {
+        if (isManaged(e)) {
+            bool wasDormant = tiers[e.index] == uint8_t(Tier::Dormant);
+            forget(e); // a dormant cell entry is dropped when the cell is next visited
+            if (wasDormant && isSimulated(e)) physics.setBodyEnabled(e, true);
+        }
+        setTier(e, Pinned);
+    }
+
+    void ActivationSystem::rebuild(const Camera& camera) {
+        clear();
+        center = viewCenter(camera);
+        for (Entity e : registry.transforms.entities()) {
+            add(e);
+        }
+    }
+
+    void ActivationSystem::clear() {
+        // Nothing stays disabled once it is no longer managed.
+        for (auto& [key, cell] : dormantCells) {
+            for (Entity e : cell) {
+                if (isManaged(e) && tiers[e.index] == uint8_t(Tier::Dormant) && registry.alive(e) && isSimulated(e)) {
+                    physics.setBodyEnabled(e, true);
+                    tiers[e.index] = Unmanaged;
+                }
+            }
+        }
+        dormantCells.clear();
+        recheckKeys.clear();
+        moved.clear();
+        awake.clear();
+        owners.clear();
+        tiers.clear();
+        awakeSlot.clear();
+        activeCount = 0;
+        dormantCount = 0;
+    }
+
+    void ActivationSystem::update(const Camera& camera) {
+        center = viewCenter(camera);
+        ++frame;
+        int budget = settings.toggleBudgetPerFrame;
+        const float activeOut = settings.activeRadius + settings.hysteresis;
+        const float reducedOut = settings.reducedRadius + settings.hysteresis;
+
+        // Wake dormant entities around the camera first; they matter most.
+        glm::ivec2 lo = cellOf(center - glm::vec2(settings.reducedRadius));
+        glm::ivec2 hi = cellOf(center + glm::vec2(settings.reducedRadius));
+        for (int y = lo.y; y <= hi.y; ++y) {
+            for (int x = lo.x; x <= hi.x; ++x) {
+                auto it = dormantCells.find(keyFor(x, y));
+                if (it == dormantCells.end()) continue;
+                std::vector<Entity>& cell = it->second;
+                for (size_t k = 0; k < cell.size();) {
+                    Entity e = cell[k];
+                    if (!keepInCell(e, glm::ivec2(x, y))) {
+                        cell[k] = cell.back();
+                        cell.pop_back();
+                        continue;
+                    }
+                    float distance = glm::length(registry.transforms.get(e)->position - center);
+                    if (distance >= settings.reducedRadius || budget <= 0) {
+                        ++k;
+                        continue;
+                    }
+                    wake(e, distance < settings.activeRadius ? Tier::Active : Tier::Reduced);
+                    --budget;
+                    cell[k] = cell.back();
+                    cell.pop_back();
+                }
+                if (cell.empty()) dormantCells.erase(it);
+            }
+        }
+
+        // Cells away from the camera are not visited above; recheck a few of
+        // them per frame so entities moved while dormant get re-filed too.
+        for (size_t n = 0; n < settings.recheckCellsPerFrame; ++n) {
+            if (recheckKeys.empty()) {
+                for (const auto& [key, cell] : dormantCells) recheckKeys.push_back(key);
+                if (recheckKeys.empty()) break;
+            }
+            int64_t key = recheckKeys.back();
+            recheckKeys.pop_back();
+            auto it = dormantCells.find(key);
+            if (it == dormantCells.end()) continue;
+            const glm::ivec2 cellCoord(int(key >> 32), int(int32_t(uint32_t(key))));
+            std::vector<Entity>& cell = it->second;
+            for (size_t k = 0; k < cell.size();) {
+                if (keepInCell(cell[k], cellCoord)) {
+                    ++k;
+                    continue;
+                }
+                cell[k] = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty()) dormantCells.erase(it);
+        }
+
+        // Filed after the scans, since inserting into dormantCells may rehash.
+        for (Entity e : moved) {
+            glm::ivec2 cell = cellOf(registry.transforms.get(e)->position);
+            dormantCells[keyFor(cell.x, cell.y)].push_back(e);
+        }
+        moved.clear();
+
+        // Demote what drifted out. Backwards, since sleeping swap-removes.
+        for (size_t i = awake.size(); i-- > 0;) {
+            Entity e = awake[i];
+            const Transform* transform = registry.alive(e) ? registry.transforms.get(e) : nullptr;
+            if (!transform) {
+                forget(e);
+                continue;
+            }
+            float distance = glm::length(transform->position - center);
+            Tier tier = static_cast<Tier>(tiers[e.index]);
+            if (distance > reducedOut) {
+                if (budget > 0) {
+                    sleep(e, transform->position);
+                    --budget;
+                }
+            }
+            else if (tier == Tier::Active && distance > activeOut) {
+                setTier(e, uint8_t(Tier::Reduced));
+            }
+            else if (tier == Tier::Reduced && distance < settings.activeRadius) {
+                setTier(e, uint8_t(Tier::Active));
+            }
+        }
+    }
+
+}
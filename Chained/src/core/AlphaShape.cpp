@@ -0,0 +1,215 @@
+#include "../headers/AlphaShape.h"
+#include "../headers/ColliderMerge.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Chained {
+
+    namespace {
+
+        // Pieces smaller than this (square pixels) would weld into degenerate
+        // Box2D polygons.
+        constexpr float MinPieceArea = 0.5f;
+
+        float cross(const glm::vec2& a, const glm::vec2& b) {
+            return a.x * b.y - a.y * b.x;
+        }
+
+        float signedArea(const std::vector<glm::vec2>& loop) {
+            float area = 0.0f;
+            for (size_t i = 0, n = loop.size(); i < n; ++i) {
+                area += cross(loop[i], loop[(i + 1) % n]);
+            }
+            return 0.5f * area;
+        }
+
+        float distanceToSegment(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b) {
+            glm::vec2 ab = b - a;
+            float lengthSq = glm::dot(ab, ab);
+            float t = lengthSq > 0.0f ? glm::clamp(glm::dot(p - a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            return glm::length(p - (a + t * ab));
+        }
+
+        // Douglas-Peucker on a closed loop, split at the point farthest
+        // from the first so both halves are open polylines.
+        std::vector<glm::vec2> simplifyLoop(const std::vector<glm::vec2>& loop, float tolerance) {
+            const size_t n = loop.size();
+            if (n <= 4) return loop;
+
+            size_t far = 0;
+            float farDist = 0.0f;
+            for (size_t i = 1; i < n; ++i) {
+                float d = glm::length(loop[i] - loop[0]);
+                if (d > farDist) { farDist = d; far = i; }
+            }
+
+            std::vector<uint8_t> keep(n, 0);
+            keep[0] = keep[far] = 1;
+            std::vector<std::pair<size_t, size_t>> spans = { { 0, far }, { far, n } };
+            while (!spans.empty()) {
+                auto [first, last] = spans.back();
+                spans.pop_back();
+                const glm::vec2& a = loop[first % n];
+                const glm::vec2& b = loop[last % n];
+                size_t worst = first;
+                float worstDist = tolerance;
+                for (size_t i = first + 1; i < last; ++i) {
+                    float d = distanceToSegment(loop[i % n], a, b);
+                    if (d > worstDist) { worstDist = d; worst = i; }
+                }
+                if (worst == first) continue;
+                keep[worst % n] = 1;
+                spans.push_back({ first, worst });
+                spans.push_back({ worst, last });
+            }
+
+            std::vector<glm::vec2> out;
+            for (size_t i = 0; i < n; ++i) {
+                if (keep[i]) out.push_back(loop[i]);
+            }
+            return out;
+        }
+
+        bool insideTriangle(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+            return cross(b - a, p - a) >= 0.0f && cross(c - b, p - b) >= 0.0f && cross(a - c, p - c) >= 0.0f;
+        }
+
+        // Ear clipping of a counter-clockwise simple polygon. Returns false,
+        // with only part of the polygon covered, if it stalls because the
+        // polygon is self-intersecting.
+        bool triangulate(const std::vector<glm::vec2>& points, std::vector<std::vector<uint32_t>>& triangles) {
+            triangles.clear();
+            std::vector<uint32_t> ring(points.size());
+            for (uint32_t i = 0; i < ring.size(); ++i) ring[i] = i;
+
+            while (ring.size() > 3) {
+                const size_t m = ring.size();
+                bool clipped = false;
+                for (size_t i = 0; i < m && !clipped; ++i) {
+                    uint32_t ia = ring[(i + m - 1) % m], ib = ring[i], ic = ring[(i + 1) % m];
+                    const glm::vec2 &a = points[ia], &b = points[ib], &c = points[ic];
+                    if (cross(b - a, c - b) <= 0.0f) continue; // reflex or flat
+                    bool empty = true;
+                    for (uint32_t k : ring) {
+                        if (k == ia || k == ib || k == ic) continue;
+                        if (points[k] == a || points[k] == b || points[k] == c) continue;
+                        if (insideTriangle(points[k], a, b, c)) { empty = false; break; }
+                    }
+                    if (!empty) continue;
+                    triangles.push_back({ ia, ib, ic });
+                    ring.erase(ring.begin() + i);
+                    clipped = true;
+                }
+                if (!clipped) return false;
+            }
+            if (ring.size() == 3) triangles.push_back(ring);
+            return true;
+        }
+
+        bool isConvex(const std::vector<uint32_t>& poly, const std::vector<glm::vec2>& points) {
+            const size_t n = poly.size();
+            for (size_t i = 0; i < n; ++i) {
+                const glm::vec2& a = points[poly[i]];
+                const glm::vec2& b = points[poly[(i + 1) % n]];
+                const glm::vec2& c = points[poly[(i + 2) % n]];
+                if (cross(b - a, c - b) < 0.0f) return false;
+            }
+            return true;
+        }
+
+        // Joins polygons a and b across their shared edge, or returns false.
+        bool joinAcrossEdge(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t>& out) {
+            const size_t na = a.size(), nb = b.size();
+            for (size_t i = 0; i < na; ++i) {
+                uint32_t u = a[i], v = a[(i + 1) % na];
+                for (size_t j = 0; j < nb; ++j) {
+                    if (b[j] != v || b[(j + 1) % nb] != u) continue;
+                    // a from v around to u, then b's vertices strictly between u and v.
+                    out.clear();
+                    for (size_t k = 0; k < na; ++k) out.push_back(a[(i + 1 + k) % na]);
+                    for (size_t k = 2; k < nb; ++k) out.push_back(b[(j + k) % nb]);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Hertel-Mehlhorn: greedily remove diagonals while the pieces stay
+        // convex and within Box2D's vertex limit.
+        void mergeConvex(std::vector<std::vector<uint32_t>>& polys, const std::vector<glm::vec2>& points) {
+            std::vector<uint32_t> joined;
+            bool merged = true;
+            while (merged) {
+                merged = false;
+                for (size_t a = 0; a < polys.size() && !merged; ++a) {
+                    for (size_t b = a + 1; b < polys.size() && !merged; ++b) {
+                        if (polys[a].size() + polys[b].size() - 2 > MaxPieceVertices) continue;
+                        if (!joinAcrossEdge(polys[a], polys[b], joined) || !isConvex(joined, points)) continue;
+                        polys[a] = joined;
+                        polys.erase(polys.begin() + b);
+                        merged = true;
+                    }
+                }
+            }
+        }
+
+    }
+
+    SliceShape buildAlphaShape(const uint8_t* rgba, int width, int height, size_t stride,
+                               uint8_t threshold, float tolerance) {
+        SliceShape shape;
+        shape.size = glm::vec2(float(width), float(height));
+
+        // Each row's opaque runs become boxes; merging them traces the outline.
+        std::vector<MergeRect> runs;
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* row = rgba + size_t(y) * stride;
+            for (int x = 0; x < width;) {
+                if (row[x * 4 + 3] < threshold) { ++x; continue; }
+                int start = x;
+                while (x < width && row[x * 4 + 3] >= threshold) ++x;
+                runs.push_back({ glm::vec2(float(start), float(y)), glm::vec2(float(x), float(y + 1)) });
+            }
+        }
+
+        const glm::vec2 center = 0.5f * shape.size;
+        auto centered = [&center](std::vector<glm::vec2> points) {
+            for (glm::vec2& p : points) p -= center;
+            return points;
+        };
+        std::vector<std::vector<uint32_t>> polys;
+        for (const MergedRegion& region : mergeRects(runs, 0.25f)) {
+            for (const auto& loop : region.loops) {
+                if (signedArea(loop) <= 0.0f) continue; // a hole
+
+                std::vector<glm::vec2> points = centered(simplifyLoop(loop, tolerance));
+                if (points.size() < 3 || signedArea(points) < MinPieceArea) continue;
+
+                // Simplification can leave the outline self-intersecting.
+                // Retry on the traced outline, and as a last resort cover
+                // the outline's bounding box rather than lose part of it.
+                if (!triangulate(points, polys)) {
+                    points = centered(loop);
+                    if (!triangulate(points, polys)) {
+                        glm::vec2 lo(INFINITY), hi(-INFINITY);
+                        for (const glm::vec2& p : points) {
+                            lo = glm::min(lo, p);
+                            hi = glm::max(hi, p);
+                        }
+                        points = { lo, { hi.x, lo.y }, hi, { lo.x, hi.y } };
+                        polys = { { 0, 1, 2, 3 } };
+                        shape.approximated = true;
+                    }
+                }
+                mergeConvex(polys, points);
+                for (const auto& poly : polys) {
+                    std::vector<glm::vec2> piece;
+                    for (uint32_t i : poly) piece.push_back(points[i]);
+                    if (signedArea(piece) >= MinPieceArea) shape.pieces.push_back(std::move(piece));
+                }
+            }
+        }
+        return shape;
+    }
+
+}
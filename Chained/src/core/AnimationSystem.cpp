@@ -0,0 +1,119 @@
+#include "../headers/AnimationSystem.h"
+#include <algorithm>
+#include <iostream>
+
+namespace Chained {
+
+    AnimationSystem::AnimationSystem(Registry& registry, const SpriteAtlas& atlas)
+        : registry(registry), atlas(atlas) {
+        std::vector<FrameTag> tags = atlas.getFrameTags();
+        if (tags.empty() && atlas.getFrameCount() > 0) {
+            FrameTag all;
+            all.name = "default";
+            all.to = int(atlas.getFrameCount()) - 1;
+            tags.push_back(all);
+        }
+
+        std::vector<uint32_t> order;
+        for (const FrameTag& tag : tags) {
+            order.clear();
+            const bool backwards = tag.direction == TagDirection::Reverse || tag.direction == TagDirection::PingPongReverse;
+            for (int k = 0; k <= tag.to - tag.from; ++k) {
+                order.push_back(uint32_t(backwards ? tag.to - k : tag.from + k));
+            }
+            // Ping-pong returns without repeating either end.
+            if (tag.direction == TagDirection::PingPong || tag.direction == TagDirection::PingPongReverse) {
+                for (size_t k = order.size() - 1; k-- > 1;) order.push_back(order[k]);
+            }
+
+            AnimationClip clip;
+            clip.name = tag.name;
+            clip.first = uint32_t(stepFrames.size());
+            clip.count = uint32_t(order.size());
+            clip.repeat = uint32_t(std::max(0, tag.repeat));
+            for (uint32_t frame : order) {
+                clip.cycleMs += uint32_t(std::max(0, atlas.getFrameDuration(frame)));
+                stepFrames.push_back(frame);
+                stepEnds.push_back(clip.cycleMs);
+            }
+            clips.push_back(clip);
+        }
+        if (clips.empty()) {
+            std::cerr << "[ERROR] Atlas has no frames to animate" << std::endl;
+        }
+    }
+
+    ClipHandle AnimationSystem::findClip(const std::string& name) const {
+        if (name.empty()) return clips.empty() ? InvalidClip : 0;
+        for (size_t i = 0; i < clips.size(); ++i) {
+            if (clips[i].name == name) return ClipHandle(i);
+        }
+        return InvalidClip;
+    }
+
+    void AnimationSystem::play(Entity e, ClipHandle clip, float speed) {
+        if (clip >= clips.size()) return;
+        Animator animator;
+        animator.clip = clip;
+        animator.speed = speed;
+        animator.startTime = clock;
+        animator.frame = stepFrames[clips[clip].first];
+        registry.animators.add(e, animator);
+    }
+
+    uint32_t AnimationSystem::sample(ClipHandle clip, double elapsed) const {
+        if (clip >= clips.size()) return 0;
+        const AnimationClip& c = clips[clip];
+        if (c.cycleMs == 0 || elapsed <= 0.0) return stepFrames[c.first];
+
+        uint64_t ms = uint64_t(elapsed * 1000.0);
+        if (c.repeat > 0 && ms >= uint64_t(c.cycleMs) * c.repeat) {
+            return stepFrames[c.first + c.count - 1];
+        }
+        uint32_t t = uint32_t(ms % c.cycleMs);
+        const uint32_t* begin = stepEnds.data() + c.first;
+        const uint32_t* step = std::upper_bound(begin, begin + c.count, t);
+        return stepFrames[c.first + uint32_t(std::min<ptrdiff_t>(step - begin, c.count - 1))];
+    }
+
+    uint32_t AnimationSystem::frameOf(const Animator& animator) const {
+        return sample(animator.clip, (clock - animator.startTime) * animator.speed);
+    }
+
+    void AnimationSystem::updateRange(size_t first, size_t last, const glm::vec2& viewMin, const glm::vec2& viewMax) {
+        for (size_t i = first; i < last; ++i) {
+            Animator& animator = registry.animators.data()[i];
+            Entity e = registry.animators.owner(i);
+            const Transform* transform = registry.transforms.get(e);
+            visible[i] = 0;
+            if (!transform || animator.frame >= atlas.getFrameCount()) continue;
+
+            // Sized by the cached frame; frames of one sheet rarely differ.
+            glm::vec2 half = 0.5f * atlas.getFrameInfo(animator.frame).pixelSize * transform->scale;
+            glm::vec2 center = transform->position + half;
+            if (transform->rotation != 0.0f) half = glm::vec2(glm::length(half));
+            if (center.x + half.x < viewMin.x || center.x - half.x > viewMax.x ||
+                center.y + half.y < viewMin.y || center.y - half.y > viewMax.y) {
+                continue;
+            }
+            visible[i] = 1;
+            if (activation && !activation->shouldTick(e)) continue;
+            animator.frame = frameOf(animator);
+        }
+    }
+
+    void AnimationSystem::update(const glm::vec2& viewMin, const glm::vec2& viewMax, JobSystem* jobs) {
+        const size_t count = registry.animators.size();
+        visible.assign(count, 0);
+        if (jobs && count >= UPDATE_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(count, UPDATE_GRAIN, [&](size_t first, size_t last) {
+                updateRange(first, last, viewMin, viewMax);
+            }));
+        }
+        else {
+            updateRange(0, count, viewMin, viewMax);
+        }
+        visibleCount = size_t(std::count(visible.begin(), visible.end(), uint8_t(1)));
+    }
+
+}
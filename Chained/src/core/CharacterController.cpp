@@ -0,0 +1,106 @@
+#include "../headers/CharacterController.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Chained {
+
+    CharacterController::CharacterController(Registry& registry)
+        : registry(registry) {
+    }
+
+    float CharacterController::sweep(const TileGrid& grid, const glm::vec2& center, const glm::vec2& halfExtents,
+                                     int axis, float delta) const {
+        if (delta == 0.0f) return 0.0f;
+        const int other = 1 - axis;
+        const float size = grid.tileSize;
+
+        // Tiles across the box's extent on the other axis. Shrunk by the skin
+        // so a box resting flush on a row does not collide with it sideways.
+        const float lo = center[other] - halfExtents[other] + settings.skin - grid.origin[other];
+        const float hi = center[other] + halfExtents[other] - settings.skin - grid.origin[other];
+        const int firstRow = int(std::floor(lo / size));
+        const int lastRow = int(std::ceil(hi / size)) - 1;
+
+        // Tiles ahead of the leading edge, nearest first. Tiles the box
+        // already overlaps are skipped, so a character pushed into a wall
+        // can still walk out of it.
+        if (delta > 0.0f) {
+            const float edge = center[axis] + halfExtents[axis] - grid.origin[axis];
+            const float target = edge + delta;
+            const int first = int(std::ceil((edge - settings.skin) / size));
+            const int last = int(std::ceil(target / size)) - 1;
+            for (int column = first; column <= last; ++column) {
+                for (int row = firstRow; row <= lastRow; ++row) {
+                    bool hit = axis == 0 ? grid.isSolid(column, row) : grid.isSolid(row, column);
+                    if (hit) return std::max(0.0f, column * size - edge);
+                }
+            }
+        }
+        else {
+            const float edge = center[axis] - halfExtents[axis] - grid.origin[axis];
+            const float target = edge + delta;
+            const int first = int(std::floor((edge + settings.skin) / size)) - 1;
+            const int last = int(std::floor(target / size));
+            for (int column = first; column >= last; --column) {
+                for (int row = firstRow; row <= lastRow; ++row) {
+                    bool hit = axis == 0 ? grid.isSolid(column, row) : grid.isSolid(row, column);
+                    if (hit) return std::min(0.0f, (column + 1) * size - edge);
+                }
+            }
+        }
+        return delta;
+    }
+
+    bool CharacterController::isGrounded(const TileGrid& grid, const glm::vec2& center, const glm::vec2& halfExtents) const {
+        const float probe = 2.0f * settings.skin;
+        return sweep(grid, center, halfExtents, 1, -probe) > -probe;
+    }
+
+    glm::vec2 CharacterController::move(const TileGrid& grid, glm::vec2 center, glm::vec2 halfExtents,
+                                        glm::vec2 delta, uint8_t& contacts) const {
+        contacts = 0;
+        if (grid.tileSize <= 0.0f) return center + delta;
+        for (int axis = 0; axis < 2; ++axis) {
+            float moved = sweep(grid, center, halfExtents, axis, delta[axis]);
+            if (moved != delta[axis]) {
+                if (axis == 0) contacts |= delta.x > 0.0f ? ContactRight : ContactLeft;
+                else contacts |= delta.y > 0.0f ? ContactAbove : ContactBelow;
+            }
+            center[axis] += moved;
+        }
+        return center;
+    }
+
+    void CharacterController::updateRange(size_t first, size_t last, float dt, const TileGrid& grid) {
+        for (size_t i = first; i < last; ++i) {
+            CharacterBody& body = registry.characters.data()[i];
+            Entity e = registry.characters.owner(i);
+            Transform* transform = registry.transforms.get(e);
+            if (!transform) continue;
+            float step = dt;
+            if (activation) {
+                if (!activation->shouldTick(e)) continue;
+                step = activation->getTickDt(e, dt);
+            }
+
+            body.velocity += settings.gravity * step;
+            transform->position = move(grid, transform->position, body.halfExtents, body.velocity * step, body.contacts);
+            if (body.contacts & (ContactLeft | ContactRight)) body.velocity.x = 0.0f;
+            if (body.contacts & (ContactBelow | ContactAbove)) body.velocity.y = 0.0f;
+            body.grounded = (body.contacts & ContactBelow) || isGrounded(grid, transform->position, body.halfExtents);
+        }
+    }
+
+    void CharacterController::update(float dt, const TileGrid& grid, JobSystem* jobs) {
+        const size_t count = registry.characters.size();
+        if (jobs && count >= UPDATE_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(count, UPDATE_GRAIN, [&](size_t first, size_t last) {
+                updateRange(first, last, dt, grid);
+            }));
+        }
+        else {
+            updateRange(0, count, dt, grid);
+        }
+    }
+
+}
@@ -0,0 +1,205 @@
+#include "../headers/ColliderMerge.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace Chained {
+
+    namespace {
+
+        uint32_t findRoot(std::vector<uint32_t>& parent, uint32_t i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        }
+
+        // Sorted coordinates with values closer than `snap` folded together.
+        std::vector<float> snappedAxis(std::vector<float> values, float snap) {
+            std::sort(values.begin(), values.end());
+            std::vector<float> axis;
+            for (float v : values) {
+                if (axis.empty() || v - axis.back() > snap) axis.push_back(v);
+            }
+            return axis;
+        }
+
+        uint32_t axisIndex(const std::vector<float>& axis, float v, float snap) {
+            return static_cast<uint32_t>(std::lower_bound(axis.begin(), axis.end(), v - snap) - axis.begin());
+        }
+
+        struct Edge {
+            uint32_t from, to; // grid point indices
+        };
+
+        // Grid of compressed coordinates for one group of touching boxes.
+        // Cell (i, j) spans xs[i]..xs[i+1], ys[j]..ys[j+1].
+        void traceGroup(const std::vector<MergeRect>& rects, const std::vector<uint32_t>& members,
+                        float snap, std::vector<MergedRegion>& out) {
+            std::vector<float> xValues, yValues;
+            for (uint32_t r : members) {
+                xValues.push_back(rects[r].min.x);
+                xValues.push_back(rects[r].max.x);
+                yValues.push_back(rects[r].min.y);
+                yValues.push_back(rects[r].max.y);
+            }
+            const std::vector<float> xs = snappedAxis(std::move(xValues), snap);
+            const std::vector<float> ys = snappedAxis(std::move(yValues), snap);
+            if (xs.size() < 2 || ys.size() < 2) return;
+
+            if ((xs.size() - 1) * (ys.size() - 1) > MERGE_MAX_GRID_CELLS) return;
+
+            const uint32_t cellsX = static_cast<uint32_t>(xs.size() - 1);
+            const uint32_t cellsY = static_cast<uint32_t>(ys.size() - 1);
+            const uint32_t pointsX = cellsX + 1;
+            std::vector<uint8_t> filled(size_t(cellsX) * cellsY, 0);
+            for (uint32_t r : members) {
+                uint32_t i0 = axisIndex(xs, rects[r].min.x, snap), i1 = axisIndex(xs, rects[r].max.x, snap);
+                uint32_t j0 = axisIndex(ys, rects[r].min.y, snap), j1 = axisIndex(ys, rects[r].max.y, snap);
+                for (uint32_t j = j0; j < j1; ++j) {
+                    for (uint32_t i = i0; i < i1; ++i) filled[size_t(j) * cellsX + i] = 1;
+                }
+            }
+            auto isFilled = [&](int64_t i, int64_t j) {
+                return i >= 0 && j >= 0 && i < cellsX && j < cellsY && filled[size_t(j) * cellsX + size_t(i)];
+            };
+
+            // Label 4-connected regions of filled cells.
+            const uint32_t Unlabeled = 0xFFFFFFFFu;
+            std::vector<uint32_t> label(filled.size(), Unlabeled);
+            std::vector<uint32_t> stack;
+            std::vector<std::vector<Edge>> regionEdges;
+            for (uint32_t seed = 0; seed < filled.size(); ++seed) {
+                if (!filled[seed] || label[seed] != Unlabeled) continue;
+                uint32_t region = static_cast<uint32_t>(regionEdges.size());
+                regionEdges.emplace_back();
+                std::vector<Edge>& edges = regionEdges.back();
+                label[seed] = region;
+                stack.push_back(seed);
+                while (!stack.empty()) {
+                    uint32_t cell = stack.back();
+                    stack.pop_back();
+                    int64_t i = cell % cellsX, j = cell / cellsX;
+                    uint32_t p00 = uint32_t(j * pointsX + i), p10 = p00 + 1;
+                    uint32_t p01 = p00 + pointsX, p11 = p01 + 1;
+
+                    // An edge for every side facing an empty cell, directed so
+                    // the empty side is on its right.
+                    if (!isFilled(i, j - 1)) edges.push_back({ p00, p10 });
+                    if (!isFilled(i + 1, j)) edges.push_back({ p10, p11 });
+                    if (!isFilled(i, j + 1)) edges.push_back({ p11, p01 });
+                    if (!isFilled(i - 1, j)) edges.push_back({ p01, p00 });
+
+                    const int64_t next[4][2] = { { i, j - 1 }, { i + 1, j }, { i, j + 1 }, { i - 1, j } };
+                    for (const auto& n : next) {
+                        if (!isFilled(n[0], n[1])) continue;
+                        uint32_t neighbor = uint32_t(n[1] * cellsX + n[0]);
+                        if (label[neighbor] != Unlabeled) continue;
+                        label[neighbor] = region;
+                        stack.push_back(neighbor);
+                    }
+                }
+            }
+
+            std::vector<std::vector<uint32_t>> regionRects(regionEdges.size());
+            for (uint32_t r : members) {
+                uint32_t i0 = axisIndex(xs, rects[r].min.x, snap), j0 = axisIndex(ys, rects[r].min.y, snap);
+                if (i0 >= cellsX || j0 >= cellsY) continue; // degenerate box, covers no cell
+                regionRects[label[size_t(j0) * cellsX + i0]].push_back(r);
+            }
+
+            for (size_t region = 0; region < regionEdges.size(); ++region) {
+                std::vector<Edge>& edges = regionEdges[region];
+                MergedRegion merged;
+                merged.rects = std::move(regionRects[region]);
+                merged.min = glm::vec2(xs.back(), ys.back());
+                merged.max = glm::vec2(xs.front(), ys.front());
+
+                // Chain edges into loops. Where regions pinch at a corner a
+                // point has two outgoing edges; either choice closes a loop.
+                std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.from < b.from; });
+                std::vector<uint8_t> used(edges.size(), 0);
+                for (size_t start = 0; start < edges.size(); ++start) {
+                    if (used[start]) continue;
+                    std::vector<glm::vec2> points;
+                    size_t current = start;
+                    while (true) {
+                        used[current] = 1;
+                        uint32_t p = edges[current].from;
+                        points.push_back({ xs[p % pointsX], ys[p / pointsX] });
+                        uint32_t to = edges[current].to;
+                        if (to == edges[start].from) break;
+                        auto range = std::equal_range(edges.begin(), edges.end(), Edge{ to, 0 },
+                            [](const Edge& a, const Edge& b) { return a.from < b.from; });
+                        size_t nextEdge = edges.size();
+                        for (auto it = range.first; it != range.second; ++it) {
+                            size_t k = size_t(it - edges.begin());
+                            if (!used[k]) { nextEdge = k; break; }
+                        }
+                        if (nextEdge == edges.size()) break; // cannot happen on a closed boundary
+                        current = nextEdge;
+                    }
+
+                    // Drop points in the middle of straight runs.
+                    std::vector<glm::vec2> loop;
+                    const size_t n = points.size();
+                    for (size_t k = 0; k < n; ++k) {
+                        const glm::vec2& prev = points[(k + n - 1) % n];
+                        const glm::vec2& cur = points[k];
+                        const glm::vec2& next = points[(k + 1) % n];
+                        bool straight = (prev.x == cur.x && cur.x == next.x) || (prev.y == cur.y && cur.y == next.y);
+                        if (!straight) loop.push_back(cur);
+                    }
+                    if (loop.size() < 3) continue;
+                    for (const glm::vec2& p : loop) {
+                        merged.min = glm::min(merged.min, p);
+                        merged.max = glm::max(merged.max, p);
+                    }
+                    merged.loops.push_back(std::move(loop));
+                }
+                if (!merged.loops.empty()) out.push_back(std::move(merged));
+            }
+        }
+
+    }
+
+    std::vector<MergedRegion> mergeRects(const std::vector<MergeRect>& rects, float snap) {
+        std::vector<MergedRegion> regions;
+        const uint32_t count = static_cast<uint32_t>(rects.size());
+        if (count == 0) return regions;
+
+        // Group boxes that overlap or touch, sweeping along x so only boxes
+        // whose x ranges meet are compared. Each group is traced on its own
+        // compressed grid, which keeps scattered boxes from sharing one huge grid.
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&rects](uint32_t a, uint32_t b) { return rects[a].min.x < rects[b].min.x; });
+        std::vector<uint32_t> parent(count);
+        std::iota(parent.begin(), parent.end(), 0u);
+        for (uint32_t a = 0; a < count; ++a) {
+            const MergeRect& ra = rects[order[a]];
+            for (uint32_t b = a + 1; b < count && rects[order[b]].min.x <= ra.max.x + snap; ++b) {
+                const MergeRect& rb = rects[order[b]];
+                if (rb.min.y > ra.max.y + snap || rb.max.y < ra.min.y - snap) continue;
+                parent[findRoot(parent, order[a])] = findRoot(parent, order[b]);
+            }
+        }
+
+        std::vector<uint32_t> byGroup(count);
+        std::iota(byGroup.begin(), byGroup.end(), 0u);
+        std::vector<uint32_t> root(count);
+        for (uint32_t i = 0; i < count; ++i) root[i] = findRoot(parent, i);
+        std::stable_sort(byGroup.begin(), byGroup.end(), [&root](uint32_t a, uint32_t b) { return root[a] < root[b]; });
+
+        std::vector<uint32_t> members;
+        for (uint32_t k = 0; k < count;) {
+            members.clear();
+            uint32_t group = root[byGroup[k]];
+            while (k < count && root[byGroup[k]] == group) members.push_back(byGroup[k++]);
+            traceGroup(rects, members, snap, regions);
+        }
+        return regions;
+    }
+
+}
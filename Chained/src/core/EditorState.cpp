@@ -3,6 +3,10 @@
 #include "../headers/SpriteAtlas.h"
 #include "../headers/ResourceManager.h"
 #include "../headers/SpriteRenderer.h"
+#include "../headers/SceneLoader.h"
+#include "../headers/WorldStreamer.h"
+#include "../headers/SpriteKernel.h"
+#include <cmath>
 #include <memory>
 #include <imgui.h>
 #include <glm/gtc/matrix_transform.hpp>
@@ -32,7 +36,7 @@ void EditorState::onEnter() {
     rm.addSearchPath("assets/textures");
 
     std::cout << "[DEBUG] Loading sprite atlas..." << std::endl;
-    spriteAtlas = std::make_shared<SpriteAtlas>("assets/textures/sprites.json");
+    spriteAtlas = std::make_shared<SpriteAtlas>("assets/textures/sprites.json", jobs);
     std::cout << "[DEBUG] Sprite atlas loaded successfully" << std::endl;
 
     assetPalette.clear();
@@ -43,6 +47,7 @@ void EditorState::onEnter() {
 
     auto shader = rm.loadShader("sprite.vert", "sprite.frag", nullptr, "sprite");
     renderer = std::make_unique<SpriteRenderer>(shader);
+    lineBatch = std::make_unique<LineBatch>(rm.loadShader("debug_line.vert", "debug_line.frag", nullptr, "debug_line"));
 
     camera = std::make_unique<Chained::Camera>(Engine::SCREEN_WIDTH, Engine::SCREEN_HEIGHT);
 
@@ -117,57 +122,78 @@ void EditorState::update(float /*dt*/) {
         }
         if (ImGui::BeginTabItem("Scene Objects")) {
             // SCENE OBJECTS LIST
-            for (int i = 0; i < static_cast<int>(objects.size()); ++i) {
-                ImGui::PushID(i);
-                if (ImGui::Selectable(objects[i].name.c_str(), i == selectedObjectIndex)) {
-                    selectedObjectIndex = i;
+            for (size_t i = 0; i < registry.transforms.size(); ++i) {
+                Entity e = registry.transforms.owner(i);
+                ImGui::PushID(static_cast<int>(e.index));
+                if (ImGui::Selectable(registry.nameOf(e).c_str(), e == selectedEntity)) {
+                    selectedEntity = e;
                 }
                 ImGui::PopID();
             }
 
             // --- OBJECT PROPERTIES ---
             ImGui::Separator();
-            if (selectedObjectIndex >= 0 && selectedObjectIndex < static_cast<int>(objects.size())) {
-                auto& obj = objects[selectedObjectIndex];
-                ImGui::Text("Object: %s", obj.name.c_str());
-                float pos[2] = { obj.position.x, obj.position.y };
+            Transform* transform = registry.transforms.get(selectedEntity);
+            Collider* collider = registry.colliders.get(selectedEntity);
+            if (transform && collider) {
+                PhysicsBody& physics = collider->desc;
+                ImGui::Text("Object: %s", registry.nameOf(selectedEntity).c_str());
+                float pos[2] = { transform->position.x, transform->position.y };
                 if (ImGui::DragFloat2("Position", pos, 1.0f)) {
-                    obj.position = { pos[0], pos[1] };
+                    transform->position = { pos[0], pos[1] };
                 }
-                if (ImGui::DragFloat("Rotation", &obj.rotation, 1.0f)) {}
-                float scale[2] = { obj.scale.x, obj.scale.y };
+                if (ImGui::DragFloat("Rotation", &transform->rotation, 1.0f)) {}
+                float scale[2] = { transform->scale.x, transform->scale.y };
                 if (ImGui::DragFloat2("Scale", scale, 0.1f)) {
-                    obj.scale = { scale[0], scale[1] };
+                    transform->scale = { scale[0], scale[1] };
                 }
                 
                 // --- PHYSICS CONTROLS ---
                 ImGui::Separator();
                 ImGui::Text("Physics");
-                ImGui::Checkbox("Physics Enabled", &obj.physics.enabled);
-                if (obj.physics.enabled) {
-                    int type = (int)obj.physics.bodyType;
+                ImGui::Checkbox("Physics Enabled", &physics.enabled);
+                if (physics.enabled) {
+                    int type = (int)physics.bodyType;
                     if (ImGui::Combo("Body Type", &type, "Static\0Dynamic\0Kinematic\0")) {
-                        obj.physics.bodyType = (Chained::BodyType)type;
+                        physics.bodyType = (Chained::BodyType)type;
+                    }
+                    int shape = (int)physics.shapeType;
+                    if (ImGui::Combo("Shape Type", &shape, "Box\0Circle\0Polygon\0")) {
+                        physics.shapeType = (Chained::ShapeType)shape;
                     }
-                    int shape = (int)obj.physics.shapeType;
-                    if (ImGui::Combo("Shape Type", &shape, "Box\0Circle\0")) {
-                        obj.physics.shapeType = (Chained::ShapeType)shape;
+                    ImGui::InputFloat2("Physics Size", glm::value_ptr(physics.size));
+                    ImGui::InputFloat("Radius", &physics.radius);
+                    ImGui::InputFloat("Density", &physics.material.density);
+                    ImGui::InputFloat("Friction", &physics.material.friction);
+                    ImGui::InputFloat("Bounciness", &physics.material.bounciness);
+                    ImGui::InputFloat("Gravity Scale", &physics.gravityScale);
+                    ImGui::InputFloat("Linear Damping", &physics.linearDamping);
+                    ImGui::InputFloat("Angular Damping", &physics.angularDamping);
+                    ImGui::Checkbox("Fixed Rotation", &physics.fixedRotation);
+                    ImGui::Checkbox("Is Sensor", &physics.isSensor);
+                    if (ImGui::TreeNode("Collision Filter")) {
+                        ImGui::InputScalar("Category", ImGuiDataType_U16, &physics.categoryBits, nullptr, nullptr, "%04X", ImGuiInputTextFlags_CharsHexadecimal);
+                        ImGui::InputScalar("Mask", ImGuiDataType_U16, &physics.maskBits, nullptr, nullptr, "%04X", ImGuiInputTextFlags_CharsHexadecimal);
+                        // One checkbox per bit: which categories this body collides with.
+                        for (int bit = 0; bit < 16; ++bit) {
+                            unsigned int mask = physics.maskBits;
+                            ImGui::PushID(bit);
+                            if (ImGui::CheckboxFlags("##mask", &mask, 1u << bit)) {
+                                physics.maskBits = static_cast<uint16_t>(mask);
+                            }
+                            ImGui::SetItemTooltip("Collides with category bit %d", bit);
+                            ImGui::PopID();
+                            if (bit % 8 != 7) ImGui::SameLine();
+                        }
+                        ImGui::InputScalar("Group", ImGuiDataType_S16, &physics.groupIndex);
+                        ImGui::TextDisabled("Same group: > 0 always collides, < 0 never");
+                        ImGui::TreePop();
                     }
-                    ImGui::InputFloat2("Physics Size", glm::value_ptr(obj.physics.size));
-                    ImGui::InputFloat("Radius", &obj.physics.radius);
-                    ImGui::InputFloat("Density", &obj.physics.material.density);
-                    ImGui::InputFloat("Friction", &obj.physics.material.friction);
-                    ImGui::InputFloat("Bounciness", &obj.physics.material.bounciness);
-                    ImGui::InputFloat("Gravity Scale", &obj.physics.gravityScale);
-                    ImGui::InputFloat("Linear Damping", &obj.physics.linearDamping);
-                    ImGui::InputFloat("Angular Damping", &obj.physics.angularDamping);
-                    ImGui::Checkbox("Fixed Rotation", &obj.physics.fixedRotation);
-                    ImGui::Checkbox("Is Sensor", &obj.physics.isSensor);
                 }
                 
                 if (ImGui::Button("Delete Object")) {
-                    objects.erase(objects.begin() + selectedObjectIndex);
-                    selectedObjectIndex = -1;
+                    registry.destroy(selectedEntity);
+                    selectedEntity = NullEntity;
                 }
             } else {
                 ImGui::Text("No object selected.");
@@ -195,7 +221,15 @@ void EditorState::update(float /*dt*/) {
             }
             ImGui::SameLine();
             if (ImGui::Button("Clear Scene")) {
-                objects.clear();
+                registry.clear();
+                selectedEntity = NullEntity;
+            }
+            if (ImGui::Button("Cook World Chunks") && !currentSceneName.empty()) {
+                // Splits the saved scene into streamable chunks next to it.
+                std::filesystem::path scenePath = std::filesystem::path("scenes") / currentSceneName;
+                std::filesystem::path manifestPath = scenePath;
+                manifestPath.replace_extension(".world");
+                WorldStreamer::cookScene(scenePath.string(), manifestPath.string(), 2048.0f, jobs);
             }
             ImGui::Text("Quick Load:");
             std::vector<std::string> sceneFiles;
@@ -245,7 +279,7 @@ void EditorState::update(float /*dt*/) {
             selectedAsset = -1;
         } else {
             // Deselect object
-            selectedObjectIndex = -1;
+            selectedEntity = NullEntity;
         }
     }
 
@@ -274,11 +308,11 @@ void EditorState::update(float /*dt*/) {
         bool objectSelected = false;
 
         // Always try to select objects first (regardless of placement mode)
-        for (int i = 0; i < objects.size(); ++i) {
-            const auto& obj = objects[i];
-            if (isObjectUnderMouse(obj, world)) {
-                selectedObjectIndex = i;
-                std::cout << "[DEBUG] Selected object: " << obj.name << " at index " << i << std::endl;
+        for (size_t i = 0; i < registry.transforms.size(); ++i) {
+            Entity e = registry.transforms.owner(i);
+            if (isObjectUnderMouse(e, world)) {
+                selectedEntity = e;
+                std::cout << "[DEBUG] Selected object: " << registry.nameOf(e) << " at index " << e.index << std::endl;
                 objectSelected = true;
                 break;
             }
@@ -308,7 +342,7 @@ void EditorState::update(float /*dt*/) {
             obj.rotation = 0.0f;
             obj.scale = { 1, 1 };
             obj.assetId = selectedAsset;
-            objects.push_back(obj);
+            registry.spawn(obj);
             
             // Exit placement mode after placing
             placementMode = false;
@@ -316,7 +350,7 @@ void EditorState::update(float /*dt*/) {
         }
         // If no object selected and not in placement mode, just deselect
         else if (!objectSelected) {
-            selectedObjectIndex = -1;
+            selectedEntity = NullEntity;
         }
     }
     wasMouseDown = isMouseDown;
@@ -332,29 +366,8 @@ void Chained::EditorState::saveSceneToJson(const std::string& filename) {
     fs::create_directories(path.parent_path(), ec);
 
     json j;
-    for (const auto& obj : objects) {
-        j["objects"].push_back({
-            {"name", obj.name},
-            {"position", {obj.position.x, obj.position.y}},
-            {"rotation", obj.rotation},
-            {"scale", {obj.scale.x, obj.scale.y}},
-            {"assetId", obj.assetId},
-            {"physics", {
-                {"enabled", obj.physics.enabled},
-                {"bodyType", (int)obj.physics.bodyType},
-                {"shapeType", (int)obj.physics.shapeType},
-                {"size", {obj.physics.size.x, obj.physics.size.y}},
-                {"radius", obj.physics.radius},
-                {"density", obj.physics.material.density},
-                {"friction", obj.physics.material.friction},
-                {"bounciness", obj.physics.material.bounciness},
-                {"gravityScale", obj.physics.gravityScale},
-                {"linearDamping", obj.physics.linearDamping},
-                {"angularDamping", obj.physics.angularDamping},
-                {"fixedRotation", obj.physics.fixedRotation},
-                {"isSensor", obj.physics.isSensor}
-            }}
-            });
+    for (Entity e : registry.transforms.entities()) {
+        j["objects"].push_back(SceneLoader::serializeObject(registry.toSceneObject(e)));
     }
     if (camera) {
         j["camera"] = {
@@ -400,60 +413,38 @@ void Chained::EditorState::loadSceneFromJson(const std::string& filename) {
         }
     }
 
-    json j;
-    file >> j;
-
-    objects.clear();
-    for (const auto& objJson : j["objects"]) {
-        SceneObject obj;
-        obj.name = objJson["name"].get<std::string>();
-        obj.position = { objJson["position"][0].get<float>(), objJson["position"][1].get<float>() };
-        obj.rotation = objJson["rotation"].get<float>();
-        obj.scale = { objJson["scale"][0].get<float>(), objJson["scale"][1].get<float>() };
-        obj.assetId = objJson["assetId"].get<int>();
-
-        // ---- Load PHYSICS! ----
-        if (objJson.contains("physics")) {
-            const auto& phy = objJson["physics"];
-            obj.physics.enabled = phy.value("enabled", false);
-            obj.physics.bodyType = (BodyType)phy.value("bodyType", 0);
-            obj.physics.shapeType = (ShapeType)phy.value("shapeType", 0);
-
-            if (phy.contains("size")) {
-                obj.physics.size = {
-                    phy["size"][0].get<float>(),
-                    phy["size"][1].get<float>()
-                };
-            }
-            obj.physics.radius = phy.value("radius", 0.5f);
-            obj.physics.material.density = phy.value("density", 1.0f);
-            obj.physics.material.friction = phy.value("friction", 0.5f);
-            obj.physics.material.bounciness = phy.value("bounciness", 0.0f);
-            obj.physics.gravityScale = phy.value("gravityScale", 1.0f);
-            obj.physics.linearDamping = phy.value("linearDamping", 0.0f);
-            obj.physics.angularDamping = phy.value("angularDamping", 0.0f);
-            obj.physics.fixedRotation = phy.value("fixedRotation", false);
-            obj.physics.isSensor = phy.value("isSensor", false);
-        }
+    file.close();
+
+    SceneLoader::SceneData scene;
+    if (!SceneLoader::loadFile(filename, scene, nullptr, jobs)) {
+        return;
+    }
 
-        objects.push_back(obj);
+    registry.clear();
+    selectedEntity = NullEntity;
+    for (const auto& obj : scene.objects) {
+        registry.spawn(*obj);
     }
 
+    const json& j = scene.document;
     if (j.contains("camera")) {
         auto camJson = j["camera"];
         glm::vec2 camPos = { camJson["pos"][0].get<float>(), camJson["pos"][1].get<float>() };
         camera->setPostion(camPos);
     }
 
-    std::cout << "[INFO] Loaded scene from: " << filename << " with " << objects.size() << " objects" << std::endl;
+    std::cout << "[INFO] Loaded scene from: " << filename << " with " << registry.count() << " objects" << std::endl;
 }
 
-bool EditorState::isObjectUnderMouse(const SceneObject& obj, const glm::vec2& mouseWorldPos) const {
-    if (obj.assetId < 0 || obj.assetId >= static_cast<int>(assetPalette.size())) {
+bool EditorState::isObjectUnderMouse(Entity e, const glm::vec2& mouseWorldPos) const {
+    const Transform* transform = registry.transforms.get(e);
+    const Sprite* sprite = registry.sprites.get(e);
+    if (!transform || !sprite) return false;
+    if (sprite->assetId < 0 || sprite->assetId >= static_cast<int>(assetPalette.size())) {
         return false;
     }
     
-    const auto& asset = assetPalette[obj.assetId];
+    const auto& asset = assetPalette[sprite->assetId];
     auto tex = spriteAtlas->getTexture();
     if (!tex) return false;
     
@@ -470,34 +461,17 @@ bool EditorState::isObjectUnderMouse(const SceneObject& obj, const glm::vec2& mo
     glm::vec2 mouseScreenPos = { float(mx), float(my) };
     
     // Get object position in screen coordinates
-    glm::vec2 objScreenPos = camera->worldToScreen(obj.position);
+    glm::vec2 objScreenPos = camera->worldToScreen(transform->position);
     objScreenPos.x += kLeftPanelWidth;
     
     // Calculate the actual size (with scale)
-    glm::vec2 scaledSize = size * obj.scale;
+    glm::vec2 scaledSize = size * transform->scale;
     glm::vec2 halfSize = 0.5f * scaledSize;
 
     return (mouseScreenPos.x >= objScreenPos.x - halfSize.x && mouseScreenPos.x <= objScreenPos.x + halfSize.x &&
             mouseScreenPos.y >= objScreenPos.y - halfSize.y && mouseScreenPos.y <= objScreenPos.y + halfSize.y);
 }
 
-void EditorState::DrawDebugLine(glm::vec2 a, glm::vec2 b, glm::vec3 color) {
-    int winWidth, winHeight;
-    glfwGetWindowSize(engine->getWindow(), &winWidth, &winHeight);
-
-    glm::vec2 screenA = camera->worldToScreen(a);
-    glm::vec2 screenB = camera->worldToScreen(b);
-    // Offset for left panel
-    screenA.x += kLeftPanelWidth;
-    screenB.x += kLeftPanelWidth;
-    // Flip Y for ImGui (top-left origin)
-    screenA.y = winHeight - screenA.y;
-    screenB.y = winHeight - screenB.y;
-
-    ImU32 col = IM_COL32(color.r * 255, color.g * 255, color.b * 255, 255);
-    ImGui::GetBackgroundDrawList()->AddLine(ImVec2(screenA.x, screenA.y), ImVec2(screenB.x, screenB.y), col, 2.0f);
-}
-
 void EditorState::render() {
     int winWidth, winHeight;
     glfwGetWindowSize(engine->getWindow(), &winWidth, &winHeight);
@@ -518,10 +492,13 @@ void EditorState::render() {
     int texH = tex->m_height;
 
     // --- Draw Sprites ---
-    for (int i = 0; i < objects.size(); ++i) {
-        const auto& obj = objects[i];
-        if (obj.assetId < 0 || obj.assetId >= static_cast<int>(assetPalette.size())) continue;
-        const auto& asset = assetPalette[obj.assetId];
+    for (size_t i = 0; i < registry.sprites.size(); ++i) {
+        const Sprite& sprite = registry.sprites.data()[i];
+        Entity e = registry.sprites.owner(i);
+        const Transform* transform = registry.transforms.get(e);
+        if (!transform) continue;
+        if (sprite.assetId < 0 || sprite.assetId >= static_cast<int>(assetPalette.size())) continue;
+        const auto& asset = assetPalette[sprite.assetId];
         glm::vec2 size = {
             asset.frame.uvRect.z * texW,
             asset.frame.uvRect.w * texH
@@ -530,60 +507,67 @@ void EditorState::render() {
 
         glm::vec4 uv = asset.frame.uvRect;
         uv.y = 1.f - uv.y - uv.w;
-        glm::vec3 color = (i == selectedObjectIndex) ? glm::vec3(1.0f, 1.0f, 0.0f) : glm::vec3(1.0f);
+        glm::vec3 color = (e == selectedEntity) ? glm::vec3(1.0f, 1.0f, 0.0f) : glm::vec3(1.0f);
 
         renderer->DrawSprite(
             tex,
-            obj.position,
+            transform->position,
             size,
-            obj.rotation,
+            transform->rotation,
             color,
             uv
         );
     }
 
-    // --- Draw Physics Collider Outlines (Box shape only) ---
-    for (int i = 0; i < objects.size(); ++i) {
-        const auto& obj = objects[i];
-        if (!obj.physics.enabled) continue;
-        if (obj.physics.shapeType != Chained::ShapeType::Box) continue;
+    // --- Draw Physics Collider Outlines ---
+    // Collected into one list and drawn in world space with the camera matrix.
+    colliderLines.clear();
+    const uint32_t boxColor = packColor(glm::vec3(1, 0, 0));
+    const uint32_t circleColor = packColor(glm::vec3(0, 1, 0));
+    const uint32_t polygonColor = packColor(glm::vec3(1, 0.5f, 0));
+    for (size_t i = 0; i < registry.colliders.size(); ++i) {
+        const PhysicsBody& physics = registry.colliders.data()[i].desc;
+        if (!physics.enabled) continue;
+
+        Entity e = registry.colliders.owner(i);
+        const Transform* transform = registry.transforms.get(e);
+        const Sprite* sprite = registry.sprites.get(e);
+        if (!transform || !sprite) continue;
+        if (sprite->assetId < 0 || sprite->assetId >= static_cast<int>(assetPalette.size())) continue;
 
         // Calculate the center of the sprite (regardless of collider size)
         glm::vec2 spriteSize = {
-            assetPalette[obj.assetId].frame.uvRect.z * texW,
-            assetPalette[obj.assetId].frame.uvRect.w * texH
-        };
-        glm::vec2 spriteCenter = obj.position + 0.5f * spriteSize;
-
-        // Use spriteCenter as the center for the collider
-        glm::vec2 center = spriteCenter;
-        glm::vec2 size = obj.physics.size * obj.scale;
-
-        // Box corners before rotation (local space)
-        glm::vec2 local[4] = {
-            {-0.5f * size.x, -0.5f * size.y},
-            {+0.5f * size.x, -0.5f * size.y},
-            {+0.5f * size.x, +0.5f * size.y},
-            {-0.5f * size.x, +0.5f * size.y}
+            assetPalette[sprite->assetId].frame.uvRect.z * texW,
+            assetPalette[sprite->assetId].frame.uvRect.w * texH
         };
+        glm::vec2 center = transform->position + 0.5f * spriteSize;
 
-        // Rotate and translate corners to world space
-        glm::vec2 world[4];
-        float c = cos(obj.rotation), s = sin(obj.rotation);
-        for (int j = 0; j < 4; ++j) {
-            world[j].x = center.x + (local[j].x * c - local[j].y * s);
-            world[j].y = center.y + (local[j].x * s + local[j].y * c);
+        if (physics.shapeType == Chained::ShapeType::Box) {
+            colliderLines.box(center, 0.5f * physics.size * transform->scale, transform->rotation, boxColor);
         }
-
-        // Draw 4 lines
-        for (int j = 0; j < 4; ++j) {
-            DrawDebugLine(world[j], world[(j + 1) % 4], glm::vec3(1, 0, 0));
+        else if (physics.shapeType == Chained::ShapeType::Circle) {
+            colliderLines.circle(center, physics.radius, circleColor);
+        }
+        else if (physics.shapeType == Chained::ShapeType::Polygon) {
+            SliceHandle slice = spriteAtlas->resolveSlice(assetPalette[sprite->assetId].name);
+            if (slice == InvalidSlice || spriteAtlas->getSliceShape(slice).pieces.empty()) {
+                colliderLines.box(center, 0.5f * physics.size * transform->scale, transform->rotation, boxColor);
+                continue;
+            }
+            const SliceShape& shape = spriteAtlas->getSliceShape(slice);
+            glm::vec2 stretch = physics.size / shape.size;
+            float c = std::cos(transform->rotation), s = std::sin(transform->rotation);
+            glm::vec2 points[MaxPieceVertices];
+            for (const auto& piece : shape.pieces) {
+                for (size_t k = 0; k < piece.size(); ++k) {
+                    glm::vec2 p = piece[k] * stretch;
+                    points[k] = center + glm::vec2(c * p.x - s * p.y, s * p.x + c * p.y);
+                }
+                colliderLines.polygon(points, piece.size(), polygonColor);
+            }
         }
     }
-
-    // --- Draw Circles (if needed) ---
-    // Add this if you have circles, otherwise ignore:
-    // for (int i = 0; i < objects.size(); ++i) { ... if (obj.physics.shapeType == Chained::ShapeType::Circle) ... }
+    lineBatch->draw(camera->getProjectionMatrix(), colliderLines);
 
     drawCameraBounds();
 
@@ -17,6 +17,11 @@ namespace Chained {
     Engine::Engine() {}
 
     Engine::~Engine() {
+        // Hands the context back to this thread before anything is torn down.
+        renderThread.reset();
+        // States wait on the job system and the GL context while they tear down.
+        currentState.reset();
+
         // Cleanup ImGui
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -45,6 +50,8 @@ namespace Chained {
             // Setup Platform/Renderer backends
             ImGui_ImplGlfw_InitForOpenGL(window, true);
             ImGui_ImplOpenGL3_Init("#version 330");
+
+            renderThread = std::make_unique<RenderThread>(window);
         }
         return success;
     }
@@ -78,8 +85,10 @@ namespace Chained {
             }, nullptr);
     #endif
 
-        glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int w, int h) {
-            glViewport(0, 0, w, h);
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow* win, int w, int h) {
+            // With the render thread running the context lives there, and
+            // frame packets carry the framebuffer size instead.
+            if (glfwGetCurrentContext() == win) glViewport(0, 0, w, h);
             });
 
         glEnable(GL_BLEND);
@@ -89,7 +98,13 @@ namespace Chained {
 
 
     void Engine::run(std::unique_ptr<GameState> initialState) {
+        // A state entered from inside another state's update needs the
+        // context back here; the outer loop restarts the thread if it wants it.
+        renderThread->stop();
+
         currentState = std::move(initialState);
+        currentState->attachJobs(&jobs);
+        currentState->attachWindow(window);
         currentState->onEnter();
 
         double lastTime = glfwGetTime();
@@ -154,25 +169,92 @@ namespace Chained {
 
             glfwPollEvents();
 
+            static bool renderThreadKeyDown = false;
+            bool renderThreadKey = glfwGetKey(window, GLFW_KEY_F4) == GLFW_PRESS;
+            if (renderThreadKey && !renderThreadKeyDown) renderThreadEnabled = !renderThreadEnabled;
+            renderThreadKeyDown = renderThreadKey;
+
+            bool threaded = renderThreadEnabled && currentState->supportsFramePackets();
+            if (!threaded) renderThread->stop();
+
             // Start the ImGui frame
-            ImGui_ImplOpenGL3_NewFrame();
+            if (!threaded) ImGui_ImplOpenGL3_NewFrame(); // the packet does this on the render thread
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
 
-            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT);
+            FramePacket* packet = nullptr;
+            if (threaded) {
+                currentState->update(deltaTime);
+                renderThread->start(); // no-op unless stopped, e.g. by a nested run()
+
+                // Frame N+1 is recorded here while the render thread may still
+                // be submitting frame N.
+                packet = &renderThread->acquire();
+                int displayW, displayH;
+                glfwGetFramebufferSize(window, &displayW, &displayH);
+                packet->setViewport(displayW, displayH);
+                packet->setClearColor(glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+                currentState->record(*packet);
+            }
+            else {
+                glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                currentState->update(deltaTime);
+                currentState->render();
+            }
 
-            currentState->update(deltaTime);
-            currentState->render();
+            static bool profilerKeyDown = false;
+            bool profilerKey = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+            if (profilerKey && !profilerKeyDown) showProfiler = !showProfiler;
+            profilerKeyDown = profilerKey;
+            jobs.endFrame();
+            if (showProfiler) drawProfiler(deltaTime);
 
             // Render ImGui
             ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-            glfwSwapBuffers(window);
+            if (packet) {
+                bool texturesPending = packet->captureUi(ImGui::GetDrawData());
+                renderThread->submit(texturesPending);
+            }
+            else {
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+                glfwSwapBuffers(window);
+            }
         }
 
+        renderThread->stop();
         currentState->onExit();
     }
+
+    void Engine::drawProfiler(float deltaTime) {
+        ImGui::SetNextWindowBgAlpha(0.8f);
+        ImGui::Begin("Profiler (F3)", &showProfiler, ImGuiWindowFlags_AlwaysAutoResize);
+        ImGui::Text("Frame: %.2f ms (%.0f FPS)", deltaTime * 1000.0f, deltaTime > 0.0f ? 1.0f / deltaTime : 0.0f);
+        ImGui::Separator();
+        if (renderThread->isRunning()) {
+            RenderThread::Stats rs = renderThread->getStats();
+            ImGui::Text("Render thread: %.2f ms submit, simulation waited %.2f ms", rs.executeMs, rs.waitMs);
+        }
+        else {
+            ImGui::Text("Render thread: off (F4)");
+        }
+        ImGui::Separator();
+        ImGui::Text("Job workers");
+        const auto& stats = jobs.frameStats();
+        for (size_t i = 0; i < stats.size(); ++i) {
+            const auto& s = stats[i];
+            char label[64];
+            snprintf(label, sizeof(label), "%.0f%%", s.utilization * 100.0);
+            if (i == 0) ImGui::Text("main");
+            else ImGui::Text("w%zu", i);
+            ImGui::SameLine(60.0f);
+            ImGui::ProgressBar(static_cast<float>(s.utilization), ImVec2(160.0f, 0.0f), label);
+            ImGui::SameLine();
+            ImGui::Text("%.2f ms  %llu jobs  %llu steals", s.busyMs,
+                static_cast<unsigned long long>(s.jobs), static_cast<unsigned long long>(s.steals));
+        }
+        ImGui::End();
+    }
 }
 
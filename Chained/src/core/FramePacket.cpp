@@ -0,0 +1,166 @@
+#include "../headers/FramePacket.h"
+#include "backends/imgui_impl_opengl3.h"
+#include <cstring>
+
+namespace Chained {
+
+    namespace {
+        // ImVector's operator= frees before copying; resize keeps the old capacity.
+        template <typename T>
+        void copyInto(ImVector<T>& dst, const ImVector<T>& src) {
+            dst.resize(src.Size);
+            if (src.Size > 0) std::memcpy(dst.Data, src.Data, src.size_in_bytes());
+        }
+    }
+
+    FramePacket::~FramePacket() {
+        for (ImDrawList* list : uiLists) IM_DELETE(list);
+    }
+
+    void FramePacket::reset() {
+        commands.clear();
+        spritePasses.clear();
+        runs.clear();
+        sprites.clear();
+        custom.clear();
+        linePassCount = 0; // lists keep their capacity for the next frame
+        recordingSprites = false;
+        viewportWidth = viewportHeight = 0;
+        clear = false;
+        ui.Clear();
+        hasUi = false;
+    }
+
+    void FramePacket::setViewport(int width, int height) {
+        viewportWidth = width;
+        viewportHeight = height;
+    }
+
+    void FramePacket::setClearColor(const glm::vec4& color) {
+        clearColor = color;
+        clear = true;
+    }
+
+    void FramePacket::beginSprites(SpriteBatch* batch, const glm::mat4& projection) {
+        if (recordingSprites) endSprites();
+        commands.push_back({ CommandType::Sprites, spritePasses.size() });
+        spritePasses.push_back({ batch, projection, runs.size(), 0 });
+        recordingSprites = true;
+    }
+
+    void FramePacket::drawSprite(const Texture2DPtr& texture, glm::vec2 position, glm::vec2 size,
+                                 float rotate, glm::vec3 color, glm::vec4 uvRect, glm::vec2 scale) {
+        if (!recordingSprites) return;
+        SpritePass& pass = spritePasses.back();
+        if (pass.runCount == 0 || runs.back().texture != texture) {
+            runs.push_back({ texture, sprites.size(), 0 });
+            ++pass.runCount;
+        }
+        sprites.push(position, size, rotate, scale, uvRect, packColor(color));
+        ++runs.back().count;
+    }
+
+    SpriteList* FramePacket::appendSprites(const Texture2DPtr& texture, size_t count, size_t& first) {
+        if (!recordingSprites) return nullptr;
+        SpritePass& pass = spritePasses.back();
+        if (pass.runCount == 0 || runs.back().texture != texture) {
+            runs.push_back({ texture, sprites.size(), 0 });
+            ++pass.runCount;
+        }
+        first = sprites.size();
+        sprites.resize(first + count);
+        runs.back().count += count;
+        return &sprites;
+    }
+
+    void FramePacket::endSprites() {
+        recordingSprites = false;
+    }
+
+    LineList& FramePacket::beginLines(LineBatch* batch, const glm::mat4& projection) {
+        if (linePassCount == linePasses.size()) linePasses.emplace_back();
+        LinePass& pass = linePasses[linePassCount];
+        pass.batch = batch;
+        pass.projection = projection;
+        pass.lines.clear();
+        commands.push_back({ CommandType::Lines, linePassCount++ });
+        return pass.lines;
+    }
+
+    void FramePacket::addCommand(std::function<void()> fn) {
+        commands.push_back({ CommandType::Custom, custom.size() });
+        custom.push_back(std::move(fn));
+    }
+
+    bool FramePacket::captureUi(const ImDrawData* drawData) {
+        ui.Clear();
+        hasUi = drawData && drawData->Valid;
+        if (!hasUi) return false;
+
+        ui.Valid = true;
+        ui.DisplayPos = drawData->DisplayPos;
+        ui.DisplaySize = drawData->DisplaySize;
+        ui.FramebufferScale = drawData->FramebufferScale;
+        ui.TotalVtxCount = drawData->TotalVtxCount;
+        ui.TotalIdxCount = drawData->TotalIdxCount;
+
+        for (int i = 0; i < drawData->CmdLists.Size; ++i) {
+            const ImDrawList* src = drawData->CmdLists[i];
+            if (static_cast<size_t>(i) == uiLists.size()) {
+                uiLists.push_back(IM_NEW(ImDrawList)(src->_Data));
+            }
+            ImDrawList* dst = uiLists[i];
+            copyInto(dst->CmdBuffer, src->CmdBuffer);
+            copyInto(dst->IdxBuffer, src->IdxBuffer);
+            copyInto(dst->VtxBuffer, src->VtxBuffer);
+            dst->Flags = src->Flags;
+            ui.CmdLists.push_back(dst);
+        }
+        ui.CmdListsCount = ui.CmdLists.Size;
+
+        // Texture requests are shared with the ImGui context, so they are only
+        // handed to the backend when the caller will wait for this packet.
+        bool texturesPending = false;
+        if (drawData->Textures) {
+            for (ImTextureData* tex : *drawData->Textures) {
+                if (tex->Status != ImTextureStatus_OK) texturesPending = true;
+            }
+        }
+        ui.Textures = texturesPending ? drawData->Textures : nullptr;
+        return texturesPending;
+    }
+
+    void FramePacket::execute() {
+        if (viewportWidth > 0 && viewportHeight > 0) {
+            glViewport(0, 0, viewportWidth, viewportHeight);
+        }
+        if (clear) {
+            glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+
+        for (const Command& cmd : commands) {
+            switch (cmd.type) {
+            case CommandType::Sprites: {
+                const SpritePass& pass = spritePasses[cmd.index];
+                pass.batch->submit(pass.projection, sprites, runs.data() + pass.firstRun, pass.runCount);
+                break;
+            }
+            case CommandType::Lines: {
+                const LinePass& pass = linePasses[cmd.index];
+                pass.batch->draw(pass.projection, pass.lines);
+                break;
+            }
+            case CommandType::Custom:
+                custom[cmd.index]();
+                break;
+            }
+        }
+
+        if (hasUi) {
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplOpenGL3_RenderDrawData(&ui);
+        }
+    }
+
+}
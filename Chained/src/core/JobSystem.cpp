@@ -0,0 +1,258 @@
+#include "../headers/JobSystem.h"
+#include <algorithm>
+#include <iostream>
+
+namespace Chained {
+
+    namespace {
+        thread_local const JobSystem* tlsSystem = nullptr;
+        thread_local size_t tlsWorker = 0;
+        // Jobs run from inside wait() are already covered by the outer job's busy time.
+        thread_local int tlsDepth = 0;
+        std::atomic<size_t> externalCursor{ 0 };
+    }
+
+    JobSystem::JobSystem(unsigned backgroundThreads) {
+        if (backgroundThreads == 0) {
+            unsigned hw = std::thread::hardware_concurrency();
+            backgroundThreads = hw > 1 ? hw - 1 : 1;
+        }
+
+        workers.reserve(backgroundThreads + 1);
+        for (unsigned i = 0; i <= backgroundThreads; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        stats.resize(workers.size());
+
+        tlsSystem = this;
+        tlsWorker = 0;
+
+        threads.reserve(backgroundThreads);
+        for (unsigned i = 1; i <= backgroundThreads; ++i) {
+            threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+        frameStart = std::chrono::steady_clock::now();
+        std::cout << "[INFO] Job system started with " << backgroundThreads << " worker threads" << std::endl;
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+        sleepCv.notify_all();
+        for (auto& thread : threads) thread.join();
+
+        // Run whatever is still queued, continuations included, so no handle
+        // is left pending; pop(0) also steals, so this empties every queue.
+        while (JobHandle job = pop(0)) {
+            execute(job, 0);
+        }
+        if (tlsSystem == this) tlsSystem = nullptr;
+    }
+
+    JobHandle JobSystem::schedule(std::function<void()> fn, std::initializer_list<JobHandle> deps) {
+        return schedule(std::move(fn), std::vector<JobHandle>(deps));
+    }
+
+    JobHandle JobSystem::schedule(std::function<void()> fn, const std::vector<JobHandle>& deps) {
+        auto job = std::make_shared<JobState>();
+        job->fn = std::move(fn);
+        return submit(std::move(job), deps);
+    }
+
+    JobHandle JobSystem::scheduleBackground(std::function<void()> fn, const std::vector<JobHandle>& deps) {
+        auto job = std::make_shared<JobState>();
+        job->fn = std::move(fn);
+        job->background = true;
+        return submit(std::move(job), deps);
+    }
+
+    JobHandle JobSystem::submit(JobHandle job, const std::vector<JobHandle>& deps) {
+        // Hold one extra count while registering so a dependency finishing
+        // mid-loop cannot release the job early.
+        job->pendingDeps.store(1, std::memory_order_relaxed);
+        for (const JobHandle& dep : deps) {
+            if (!dep) continue;
+            std::lock_guard<std::mutex> lock(dep->mutex);
+            if (!dep->done.load(std::memory_order_acquire)) {
+                job->pendingDeps.fetch_add(1, std::memory_order_relaxed);
+                dep->continuations.push_back(job);
+            }
+        }
+        if (job->pendingDeps.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            push(job);
+        }
+        return job;
+    }
+
+    JobHandle JobSystem::parallelFor(size_t count, size_t grain, std::function<void(size_t, size_t)> fn,
+                                     const std::vector<JobHandle>& deps) {
+        if (count == 0) return schedule([]() {}, deps);
+
+        // A few ranges per worker leaves room for stealing to even out uneven ranges.
+        grain = std::max<size_t>(grain, 1);
+        size_t perRange = std::max(grain, (count + workers.size() * 4 - 1) / (workers.size() * 4));
+        perRange = (perRange + grain - 1) / grain * grain;
+        auto body = std::make_shared<std::function<void(size_t, size_t)>>(std::move(fn));
+
+        std::vector<JobHandle> parts;
+        parts.reserve((count + perRange - 1) / perRange);
+        for (size_t begin = 0; begin < count; begin += perRange) {
+            size_t end = std::min(count, begin + perRange);
+            parts.push_back(schedule([body, begin, end]() { (*body)(begin, end); }, deps));
+        }
+        if (parts.size() == 1) return parts.front();
+        return schedule([]() {}, parts);
+    }
+
+    void JobSystem::wait(const JobHandle& handle) {
+        // Owned threads help by running their own queue oldest first: that is
+        // work they scheduled before the handle, so in-order pipelines keep
+        // their order. Background jobs are left to the workers, so a chunk
+        // load never runs in the middle of a wait. Threads the system does
+        // not own, such as the render thread, never run jobs.
+        size_t index = currentWorker();
+        while (!isDone(handle)) {
+            if (index < workers.size()) {
+                if (JobHandle job = popOldest(index)) {
+                    execute(job, index);
+                    continue;
+                }
+            }
+            // Nothing to help with: sleep on the handle. Round-robin pushes
+            // from other threads can still land in this queue, hence the
+            // timeout.
+            std::unique_lock<std::mutex> lock(handle->mutex);
+            handle->finished.wait_for(lock, std::chrono::milliseconds(1),
+                [&]() { return handle->done.load(std::memory_order_acquire); });
+        }
+    }
+
+    void JobSystem::endFrame() {
+        auto now = std::chrono::steady_clock::now();
+        double frameMs = std::chrono::duration<double, std::milli>(now - frameStart).count();
+        frameStart = now;
+
+        for (size_t i = 0; i < workers.size(); ++i) {
+            Worker& w = *workers[i];
+            WorkerStats& s = stats[i];
+            s.busyMs = w.busyNs.exchange(0) / 1.0e6;
+            s.utilization = frameMs > 0.0 ? std::min(1.0, s.busyMs / frameMs) : 0.0;
+            s.jobs = w.jobs.exchange(0);
+            s.steals = w.steals.exchange(0);
+        }
+    }
+
+    void JobSystem::workerLoop(unsigned index) {
+        tlsSystem = this;
+        tlsWorker = index;
+        while (running.load(std::memory_order_acquire)) {
+            if (JobHandle job = pop(index)) {
+                execute(job, index);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCv.wait(lock, [this]() { return queued.load(std::memory_order_acquire) > 0 || !running; });
+        }
+    }
+
+    size_t JobSystem::currentWorker() const {
+        // Threads the system does not own get an index past the end: they
+        // only steal, and their pushes are spread round-robin.
+        return tlsSystem == this ? tlsWorker : workers.size();
+    }
+
+    void JobSystem::push(JobHandle job) {
+        size_t index = currentWorker();
+        if (job->background && workers.size() > 1 && (index == 0 || index >= workers.size())) {
+            index = 1 + externalCursor.fetch_add(1, std::memory_order_relaxed) % (workers.size() - 1);
+        }
+        else if (index >= workers.size()) {
+            index = externalCursor.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        }
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->queue.push_back(std::move(job));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        // Taking the lock orders this wake-up after any worker's predicate check.
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        sleepCv.notify_one();
+    }
+
+    JobHandle JobSystem::pop(size_t index) {
+        if (index < workers.size()) {
+            Worker& own = *workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.queue.empty()) {
+                JobHandle job = std::move(own.queue.back());
+                own.queue.pop_back();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        size_t n = workers.size();
+        size_t start = index < n ? index + 1 : 0;
+        for (size_t k = 0; k < n; ++k) {
+            size_t victim = (start + k) % n;
+            if (victim == index) continue;
+            Worker& other = *workers[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.queue.empty()) {
+                JobHandle job = std::move(other.queue.front());
+                other.queue.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                if (index < n) workers[index]->steals.fetch_add(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    JobHandle JobSystem::popOldest(size_t index) {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        auto it = std::find_if(own.queue.begin(), own.queue.end(), [](const JobHandle& job) { return !job->background; });
+        if (it == own.queue.end()) return nullptr;
+        JobHandle job = std::move(*it);
+        own.queue.erase(it);
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    void JobSystem::execute(const JobHandle& job, size_t index) {
+        auto start = std::chrono::steady_clock::now();
+        ++tlsDepth;
+        job->fn();
+        job->fn = nullptr; // drop captures now rather than when the last handle goes
+        --tlsDepth;
+
+        if (index < workers.size()) {
+            Worker& w = *workers[index];
+            w.jobs.fetch_add(1, std::memory_order_relaxed);
+            if (tlsDepth == 0) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                w.busyNs.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+            }
+        }
+        complete(job);
+    }
+
+    void JobSystem::complete(const JobHandle& job) {
+        std::vector<JobHandle> ready;
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->done.store(true, std::memory_order_release);
+            ready.swap(job->continuations);
+        }
+        job->finished.notify_all();
+        for (JobHandle& next : ready) {
+            if (next->pendingDeps.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                push(std::move(next));
+            }
+        }
+    }
+
+}
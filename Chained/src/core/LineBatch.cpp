@@ -0,0 +1,118 @@
+#include "../headers/LineBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+namespace Chained {
+
+    namespace {
+        constexpr int CircleSegments = 24;
+
+        // Unit circle computed once; circles only scale and offset it.
+        struct UnitCircle {
+            glm::vec2 points[CircleSegments];
+            UnitCircle() {
+                for (int i = 0; i < CircleSegments; ++i) {
+                    float a = 6.28318530718f * i / CircleSegments;
+                    points[i] = { std::cos(a), std::sin(a) };
+                }
+            }
+        };
+        const UnitCircle unitCircle;
+    }
+
+    void LineList::line(glm::vec2 a, glm::vec2 b, uint32_t color) {
+        vertices.push_back({ a.x, a.y, color });
+        vertices.push_back({ b.x, b.y, color });
+    }
+
+    void LineList::polygon(const glm::vec2* points, size_t count, uint32_t color) {
+        if (count < 2) return;
+        for (size_t i = 0; i < count; ++i) {
+            line(points[i], points[(i + 1) % count], color);
+        }
+    }
+
+    void LineList::box(glm::vec2 center, glm::vec2 halfSize, float rotation, uint32_t color) {
+        float c = std::cos(rotation), s = std::sin(rotation);
+        glm::vec2 ax = { halfSize.x * c, halfSize.x * s };
+        glm::vec2 ay = { -halfSize.y * s, halfSize.y * c };
+        glm::vec2 corners[4] = {
+            center - ax - ay,
+            center + ax - ay,
+            center + ax + ay,
+            center - ax + ay
+        };
+        polygon(corners, 4, color);
+    }
+
+    void LineList::circle(glm::vec2 center, float radius, uint32_t color) {
+        glm::vec2 points[CircleSegments];
+        for (int i = 0; i < CircleSegments; ++i) {
+            points[i] = center + radius * unitCircle.points[i];
+        }
+        polygon(points, CircleSegments, color);
+    }
+
+    void LineList::cross(glm::vec2 center, float halfSize, uint32_t color) {
+        line(center - glm::vec2(halfSize, 0.0f), center + glm::vec2(halfSize, 0.0f), color);
+        line(center - glm::vec2(0.0f, halfSize), center + glm::vec2(0.0f, halfSize), color);
+    }
+
+    LineBatch::LineBatch(ShaderPtr shader, size_t maxSegmentsPerDraw)
+        : m_shader(shader), m_capacity(maxSegmentsPerDraw * 2) {
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(LineVertex), nullptr, GL_STREAM_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex), (void*)offsetof(LineVertex, color));
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    LineBatch::~LineBatch() {
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void LineBatch::draw(const glm::mat4& projection, const LineList& lines) {
+        m_drawCalls = 0;
+        if (lines.vertices.empty()) return;
+
+        m_shader->use();
+        m_shader->setUniform("projection", projection);
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+        const size_t total = lines.vertices.size();
+        for (size_t first = 0; first < total; first += m_capacity) {
+            size_t count = std::min(m_capacity, total - first);
+
+            // Orphan the previous contents so the driver does not wait on them.
+            void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, m_capacity * sizeof(LineVertex),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if (!mapped) {
+                std::cerr << "[ERROR] LineBatch could not map vertex buffer" << std::endl;
+                break;
+            }
+            std::memcpy(mapped, lines.vertices.data() + first, count * sizeof(LineVertex));
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+
+            glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(count));
+            ++m_drawCalls;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+}
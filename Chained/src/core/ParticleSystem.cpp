@@ -0,0 +1,274 @@
+#include "../headers/ParticleSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CH_SIMD_X86 1
+#include <emmintrin.h>
+#endif
+
+namespace Chained {
+
+    namespace {
+
+        glm::vec4 sampleCurve(const ParticleCurve& curve, float t, const glm::vec4& fallback) {
+            if (curve.empty()) return fallback;
+            if (t <= curve.front().t) return curve.front().value;
+            for (size_t k = 1; k < curve.size(); ++k) {
+                const ParticleKey& a = curve[k - 1];
+                const ParticleKey& b = curve[k];
+                if (t > b.t) continue;
+                float span = b.t - a.t;
+                return span > 0.0f ? glm::mix(a.value, b.value, (t - a.t) / span) : b.value;
+            }
+            return curve.back().value;
+        }
+
+    }
+
+    float ParticleSystem::Emitter::random() {
+        // xorshift32; the top 24 bits make a float in [0, 1).
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return float(rng >> 8) * (1.0f / 16777216.0f);
+    }
+
+    EmitterHandle ParticleSystem::addEmitter(const ParticleEmitterDesc& desc, const SpriteAtlas& atlas) {
+        auto e = std::make_unique<Emitter>();
+        e->desc = desc;
+        e->texture = atlas.getTexture();
+
+        // The clip's frames, or every frame of the atlas.
+        int from = 0, to = int(atlas.getFrameCount()) - 1;
+        bool reverse = false;
+        if (!desc.clip.empty()) {
+            const std::vector<FrameTag>& tags = atlas.getFrameTags();
+            auto tag = std::find_if(tags.begin(), tags.end(), [&](const FrameTag& t) { return t.name == desc.clip; });
+            if (tag != tags.end()) {
+                from = tag->from;
+                to = tag->to;
+                reverse = tag->direction == TagDirection::Reverse || tag->direction == TagDirection::PingPongReverse;
+            }
+            else {
+                std::cerr << "[ERROR] Unknown particle clip: " << desc.clip << std::endl;
+            }
+        }
+        for (int k = 0; k <= to - from; ++k) {
+            const SliceInfo& info = atlas.getFrameInfo(size_t(reverse ? to - k : from + k));
+            e->frames.push_back({ info.pixelSize, info.uvRect });
+        }
+        if (e->frames.empty()) {
+            std::cerr << "[ERROR] Particle atlas has no frames; the emitter will not be drawn" << std::endl;
+        }
+
+        float largest = 0.0f;
+        for (size_t k = 0; k < CURVE_STEPS; ++k) {
+            float t = float(k) / float(CURVE_STEPS - 1);
+            e->sizeTable[k] = sampleCurve(desc.size, t, glm::vec4(1.0f)).x;
+            glm::vec4 c = sampleCurve(desc.color, t, glm::vec4(1.0f));
+            e->colorTable[k] = packColor(glm::vec3(c.r, c.g, c.b), c.a);
+            largest = std::max(largest, std::abs(e->sizeTable[k]));
+        }
+        for (const FrameSprite& frame : e->frames) {
+            e->reach = std::max(e->reach, 0.5f * glm::length(frame.size) * largest);
+        }
+        e->rotates = desc.spin.x != 0.0f || desc.spin.y != 0.0f;
+
+        size_t capacity = desc.capacity;
+        if (capacity == 0) {
+            capacity = size_t(std::ceil(std::max(0.0f, desc.rate) * std::max(desc.lifetime.x, desc.lifetime.y))) + desc.burst;
+        }
+        capacity = std::max<size_t>(capacity, 1);
+        e->x.resize(capacity); e->y.resize(capacity);
+        e->vx.resize(capacity); e->vy.resize(capacity);
+        e->age.resize(capacity);
+        e->invLife.resize(capacity);
+        e->rotation.resize(capacity); e->spin.resize(capacity);
+
+        // Distinct streams per emitter; xorshift must not start at zero.
+        e->rng ^= uint32_t(emitters.size()) * 0x85EBCA6Bu;
+        if (e->rng == 0) e->rng = 1;
+
+        spawn(*e, desc.burst);
+        emitters.push_back(std::move(e));
+        return EmitterHandle(emitters.size() - 1);
+    }
+
+    void ParticleSystem::clear() {
+        emitters.clear();
+    }
+
+    void ParticleSystem::setPosition(EmitterHandle emitter, const glm::vec2& position) {
+        if (emitter < emitters.size()) emitters[emitter]->desc.position = position;
+    }
+
+    void ParticleSystem::setRate(EmitterHandle emitter, float rate) {
+        if (emitter < emitters.size()) emitters[emitter]->desc.rate = rate;
+    }
+
+    size_t ParticleSystem::burst(EmitterHandle emitter, size_t count) {
+        if (emitter >= emitters.size()) return 0;
+        Emitter& e = *emitters[emitter];
+        size_t before = e.count;
+        spawn(e, count);
+        return e.count - before;
+    }
+
+    size_t ParticleSystem::size() const {
+        size_t total = 0;
+        for (const auto& e : emitters) total += e->count;
+        return total;
+    }
+
+    void ParticleSystem::spawn(Emitter& e, size_t count) {
+        const ParticleEmitterDesc& d = e.desc;
+        count = std::min(count, e.x.size() - e.count);
+        for (size_t k = 0; k < count; ++k) {
+            size_t i = e.count++;
+            e.x[i] = d.position.x + (e.random() - 0.5f) * d.area.x;
+            e.y[i] = d.position.y + (e.random() - 0.5f) * d.area.y;
+            float angle = d.direction + (e.random() - 0.5f) * d.spread;
+            float speed = glm::mix(d.speed.x, d.speed.y, e.random());
+            e.vx[i] = std::cos(angle) * speed;
+            e.vy[i] = std::sin(angle) * speed;
+            e.age[i] = 0.0f;
+            e.invLife[i] = 1.0f / std::max(glm::mix(d.lifetime.x, d.lifetime.y, e.random()), 0.001f);
+            e.rotation[i] = e.rotates ? e.random() * 6.2831853f : 0.0f;
+            e.spin[i] = glm::mix(d.spin.x, d.spin.y, e.random());
+            // Culling uses these until the next update recomputes them.
+            e.boundsMin = glm::min(e.boundsMin, glm::vec2(e.x[i], e.y[i]));
+            e.boundsMax = glm::max(e.boundsMax, glm::vec2(e.x[i], e.y[i]));
+        }
+    }
+
+    void ParticleSystem::remove(Emitter& e, size_t i) {
+        size_t last = --e.count;
+        if (i == last) return;
+        e.x[i] = e.x[last]; e.y[i] = e.y[last];
+        e.vx[i] = e.vx[last]; e.vy[i] = e.vy[last];
+        e.age[i] = e.age[last];
+        e.invLife[i] = e.invLife[last];
+        e.rotation[i] = e.rotation[last]; e.spin[i] = e.spin[last];
+    }
+
+    void ParticleSystem::integrate(Emitter& e, size_t first, size_t last, float dt) {
+        // Semi-implicit Euler with exponential drag, as for projectiles.
+        const float damp = std::exp(-e.desc.drag * dt);
+        const float gx = e.desc.gravity.x * dt, gy = e.desc.gravity.y * dt;
+        float* x = e.x.data(); float* y = e.y.data();
+        float* vx = e.vx.data(); float* vy = e.vy.data();
+        float* age = e.age.data(); const float* invLife = e.invLife.data();
+        float* rotation = e.rotation.data(); const float* spin = e.spin.data();
+        size_t i = first;
+#ifdef CH_SIMD_X86
+        const __m128 step = _mm_set1_ps(dt), drag = _mm_set1_ps(damp);
+        const __m128 dvx = _mm_set1_ps(gx), dvy = _mm_set1_ps(gy);
+        for (; i + 4 <= last; i += 4) {
+            __m128 nvx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx + i), drag), dvx);
+            __m128 nvy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), drag), dvy);
+            _mm_storeu_ps(vx + i, nvx);
+            _mm_storeu_ps(vy + i, nvy);
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(nvx, step)));
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(nvy, step)));
+            _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(invLife + i), step)));
+            _mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(_mm_loadu_ps(spin + i), step)));
+        }
+#endif
+        for (; i < last; ++i) {
+            vx[i] = vx[i] * damp + gx;
+            vy[i] = vy[i] * damp + gy;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            age[i] += invLife[i] * dt;
+            rotation[i] += spin[i] * dt;
+        }
+    }
+
+    void ParticleSystem::update(float dt, JobSystem* jobs) {
+        for (auto& owned : emitters) {
+            Emitter& e = *owned;
+            if (e.desc.rate > 0.0f) {
+                e.spawnCarry += e.desc.rate * dt;
+                size_t due = size_t(e.spawnCarry);
+                e.spawnCarry -= float(due);
+                spawn(e, due);
+            }
+            if (e.count == 0) continue;
+
+            if (jobs && e.count >= INTEGRATE_GRAIN * 2) {
+                jobs->wait(jobs->parallelFor(e.count, INTEGRATE_GRAIN,
+                    [&e, dt](size_t first, size_t last) { integrate(e, first, last, dt); }));
+            }
+            else {
+                integrate(e, 0, e.count, dt);
+            }
+
+            // Walk backwards so the swap-remove only pulls in slots already
+            // handled; survivors grow the bounds used to cull the emitter.
+            glm::vec2 lo(INFINITY), hi(-INFINITY);
+            for (size_t i = e.count; i-- > 0;) {
+                if (e.age[i] >= 1.0f) {
+                    remove(e, i);
+                    continue;
+                }
+                lo = glm::min(lo, glm::vec2(e.x[i], e.y[i]));
+                hi = glm::max(hi, glm::vec2(e.x[i], e.y[i]));
+            }
+            e.boundsMin = lo;
+            e.boundsMax = hi;
+        }
+    }
+
+    void ParticleSystem::writeSprites(const Emitter& e, SpriteList& out, size_t dst, size_t first, size_t last) {
+        const size_t frameCount = e.frames.size();
+        const float frameRate = e.desc.frameRate;
+        for (size_t i = first; i < last; ++i, ++dst) {
+            const float t = std::clamp(e.age[i], 0.0f, 1.0f);
+            const size_t k = std::min(CURVE_STEPS - 1, size_t(t * CURVE_STEPS));
+            const size_t f = frameRate > 0.0f ? size_t(e.age[i] / e.invLife[i] * frameRate) % frameCount
+                                              : std::min(frameCount - 1, size_t(t * frameCount));
+            const FrameSprite& frame = e.frames[f];
+            const float w = frame.size.x * e.sizeTable[k], h = frame.size.y * e.sizeTable[k];
+            out.x[dst] = e.x[i] - 0.5f * w;
+            out.y[dst] = e.y[i] - 0.5f * h;
+            out.width[dst] = w;
+            out.height[dst] = h;
+            out.scaleX[dst] = 1.0f;
+            out.scaleY[dst] = 1.0f;
+            out.rotation[dst] = e.rotation[i];
+            out.u[dst] = frame.uvRect.x;
+            out.v[dst] = frame.uvRect.y;
+            out.uw[dst] = frame.uvRect.z;
+            out.vh[dst] = frame.uvRect.w;
+            out.color[dst] = e.colorTable[k];
+        }
+    }
+
+    void ParticleSystem::record(FramePacket& packet, const glm::vec2& viewMin, const glm::vec2& viewMax, JobSystem* jobs) const {
+        for (const auto& owned : emitters) {
+            const Emitter& e = *owned;
+            if (e.count == 0 || e.frames.empty() || !e.texture) continue;
+            if (e.boundsMin.x - e.reach > viewMax.x || e.boundsMax.x + e.reach < viewMin.x ||
+                e.boundsMin.y - e.reach > viewMax.y || e.boundsMax.y + e.reach < viewMin.y) {
+                continue;
+            }
+
+            size_t first = 0;
+            SpriteList* list = packet.appendSprites(e.texture, e.count, first);
+            if (!list) return;
+            list->anyRotated |= e.rotates;
+            SpriteList& out = *list;
+            if (jobs && e.count >= WRITE_GRAIN * 2) {
+                jobs->wait(jobs->parallelFor(e.count, WRITE_GRAIN, [&e, &out, first](size_t from, size_t to) {
+                    writeSprites(e, out, first + from, from, to);
+                }));
+            }
+            else {
+                writeSprites(e, out, first, 0, e.count);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,143 @@
+#include "../headers/ProjectileSystem.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CH_SIMD_X86 1
+#include <emmintrin.h>
+#endif
+
+namespace Chained {
+
+    ProjectileSystem::ProjectileSystem(size_t capacity) {
+        x.resize(capacity); y.resize(capacity);
+        prevX.resize(capacity); prevY.resize(capacity);
+        vx.resize(capacity); vy.resize(capacity);
+        life.resize(capacity);
+        radius.resize(capacity);
+        filter.resize(capacity);
+        userData.resize(capacity);
+
+        rays.resize(capacity);
+        casts.resize(capacity);
+        raySlot.resize(capacity);
+        castSlot.resize(capacity);
+        rayHits.resize(capacity);
+        castHits.resize(capacity);
+        slotHit.resize(capacity);
+        hits.reserve(capacity);
+    }
+
+    bool ProjectileSystem::spawn(const ProjectileDesc& desc) {
+        if (count == x.size()) return false;
+        size_t i = count++;
+        x[i] = prevX[i] = desc.position.x;
+        y[i] = prevY[i] = desc.position.y;
+        vx[i] = desc.velocity.x;
+        vy[i] = desc.velocity.y;
+        life[i] = desc.lifetime;
+        radius[i] = desc.radius;
+        filter[i] = desc.filter;
+        userData[i] = desc.userData;
+        return true;
+    }
+
+    void ProjectileSystem::clear() {
+        count = 0;
+        hits.clear();
+    }
+
+    void ProjectileSystem::remove(size_t i) {
+        size_t last = --count;
+        if (i == last) return;
+        x[i] = x[last]; y[i] = y[last];
+        prevX[i] = prevX[last]; prevY[i] = prevY[last];
+        vx[i] = vx[last]; vy[i] = vy[last];
+        life[i] = life[last];
+        radius[i] = radius[last];
+        filter[i] = filter[last];
+        userData[i] = userData[last];
+        slotHit[i] = slotHit[last];
+    }
+
+    void ProjectileSystem::integrate(size_t first, size_t last, float dt) {
+        // Semi-implicit Euler: velocity first, then position with the new velocity.
+        const float gx = gravity.x * dt, gy = gravity.y * dt;
+        size_t i = first;
+#ifdef CH_SIMD_X86
+        const __m128 step = _mm_set1_ps(dt);
+        const __m128 dvx = _mm_set1_ps(gx), dvy = _mm_set1_ps(gy);
+        for (; i + 4 <= last; i += 4) {
+            __m128 px = _mm_loadu_ps(&x[i]), py = _mm_loadu_ps(&y[i]);
+            _mm_storeu_ps(&prevX[i], px);
+            _mm_storeu_ps(&prevY[i], py);
+            __m128 nvx = _mm_add_ps(_mm_loadu_ps(&vx[i]), dvx);
+            __m128 nvy = _mm_add_ps(_mm_loadu_ps(&vy[i]), dvy);
+            _mm_storeu_ps(&vx[i], nvx);
+            _mm_storeu_ps(&vy[i], nvy);
+            _mm_storeu_ps(&x[i], _mm_add_ps(px, _mm_mul_ps(nvx, step)));
+            _mm_storeu_ps(&y[i], _mm_add_ps(py, _mm_mul_ps(nvy, step)));
+            _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), step));
+        }
+#endif
+        for (; i < last; ++i) {
+            prevX[i] = x[i];
+            prevY[i] = y[i];
+            vx[i] += gx;
+            vy[i] += gy;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            life[i] -= dt;
+        }
+    }
+
+    void ProjectileSystem::update(float dt, PhysicsSystem& physics, JobSystem* jobs) {
+        hits.clear();
+        if (count == 0) return;
+
+        if (jobs && count >= INTEGRATE_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(count, INTEGRATE_GRAIN,
+                [this, dt](size_t first, size_t last) { integrate(first, last, dt); }));
+        }
+        else {
+            integrate(0, count, dt);
+        }
+
+        // Sweep each projectile over the segment it just covered. Point-sized
+        // ones are rays, the rest circle casts.
+        size_t rayCount = 0, castCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            slotHit[i] = QueryHit{};
+            glm::vec2 from{ prevX[i], prevY[i] }, to{ x[i], y[i] };
+            if (from == to) continue;
+            if (radius[i] > 0.0f) {
+                ShapeCastQuery& q = casts[castCount];
+                q.shape = ShapeType::Circle;
+                q.radius = radius[i];
+                q.from = from;
+                q.to = to;
+                q.filter = filter[i];
+                castSlot[castCount++] = static_cast<uint32_t>(i);
+            }
+            else {
+                rays[rayCount] = { from, to, filter[i] };
+                raySlot[rayCount++] = static_cast<uint32_t>(i);
+            }
+        }
+        physics.raycast(rays.data(), rayCount, rayHits.data(), jobs);
+        physics.shapeCast(casts.data(), castCount, castHits.data(), jobs);
+        for (size_t k = 0; k < rayCount; ++k) slotHit[raySlot[k]] = rayHits[k];
+        for (size_t k = 0; k < castCount; ++k) slotHit[castSlot[k]] = castHits[k];
+
+        // Walk backwards so the swap-remove only pulls in slots already handled.
+        for (size_t i = count; i-- > 0;) {
+            const QueryHit& hit = slotHit[i];
+            if (hit.fraction < 1.0f) {
+                hits.push_back({ filter[i].ignore, hit.entity, hit.point, hit.normal, { vx[i], vy[i] }, userData[i] });
+                remove(i);
+            }
+            else if (life[i] <= 0.0f) {
+                remove(i);
+            }
+        }
+    }
+
+}
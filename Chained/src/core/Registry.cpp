@@ -0,0 +1,105 @@
+#include "../headers/Registry.h"
+#include "../headers/SpriteAtlas.h"
+
+namespace Chained {
+
+    Entity Registry::create() {
+        uint32_t index;
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(generations.size());
+            generations.push_back(0);
+        }
+        ++aliveCount;
+        return { index, generations[index] };
+    }
+
+    void Registry::destroy(Entity e) {
+        if (!alive(e)) return;
+        transforms.remove(e);
+        sprites.remove(e);
+        bodies.remove(e);
+        nameIds.remove(e);
+        colliders.remove(e);
+        characters.remove(e);
+        animators.remove(e);
+        ++generations[e.index];
+        freeIndices.push_back(e.index);
+        --aliveCount;
+    }
+
+    bool Registry::alive(Entity e) const {
+        return e.index < generations.size() && generations[e.index] == e.generation;
+    }
+
+    void Registry::clear() {
+        transforms.clear();
+        sprites.clear();
+        bodies.clear();
+        nameIds.clear();
+        colliders.clear();
+        characters.clear();
+        animators.clear();
+        // Bump every generation so handles from before the clear stay dead.
+        freeIndices.clear();
+        for (uint32_t i = 0; i < generations.size(); ++i) {
+            ++generations[i];
+            freeIndices.push_back(static_cast<uint32_t>(generations.size()) - 1 - i);
+        }
+        aliveCount = 0;
+    }
+
+    Entity Registry::spawn(const SceneObject& obj) {
+        Entity e = create();
+        StringId name = internName(obj.name);
+        transforms.add(e, { obj.position, obj.rotation, obj.scale });
+        sprites.add(e, { obj.assetId, sliceFor(name) });
+        nameIds.add(e, { name });
+        colliders.add(e, { obj.physics });
+        return e;
+    }
+
+    SceneObject Registry::toSceneObject(Entity e) const {
+        SceneObject obj;
+        if (const Transform* t = transforms.get(e)) {
+            obj.position = t->position;
+            obj.rotation = t->rotation;
+            obj.scale = t->scale;
+        }
+        if (const Sprite* s = sprites.get(e)) obj.assetId = s->assetId;
+        if (const NameId* n = nameIds.get(e)) obj.name = names.str(n->id);
+        if (const Collider* c = colliders.get(e)) obj.physics = c->desc;
+        return obj;
+    }
+
+    const std::string& Registry::nameOf(Entity e) const {
+        const NameId* n = nameIds.get(e);
+        return names.str(n ? n->id : InvalidStringId);
+    }
+
+    void Registry::bindAtlas(const SpriteAtlas* newAtlas) {
+        atlas = newAtlas;
+        sliceByName.clear();
+        for (size_t i = 0; i < sprites.size(); ++i) {
+            const NameId* n = nameIds.get(sprites.owner(i));
+            sprites.data()[i].slice = n ? sliceFor(n->id) : InvalidSlice;
+        }
+    }
+
+    SliceHandle Registry::sliceFor(StringId name) {
+        if (!atlas || name == InvalidStringId) return InvalidSlice;
+        if (name >= sliceByName.size()) {
+            sliceByName.resize(names.size(), InvalidSlice);
+        }
+        // InvalidSlice doubles as "not looked up yet"; names with no slice
+        // are simply retried, which only happens at spawn time.
+        if (sliceByName[name] == InvalidSlice) {
+            sliceByName[name] = atlas->resolveSlice(names.str(name));
+        }
+        return sliceByName[name];
+    }
+
+}
@@ -0,0 +1,101 @@
+#include "../headers/RenderThread.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <iostream>
+
+namespace Chained {
+
+    RenderThread::RenderThread(GLFWwindow* window) : window(window) {}
+
+    RenderThread::~RenderThread() {
+        stop();
+    }
+
+    void RenderThread::start() {
+        if (running) return;
+        glfwMakeContextCurrent(nullptr);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writeIndex = 0;
+            queuedIndex = -1;
+            executingIndex = -1;
+            stopRequested = false;
+        }
+        thread = std::thread([this]() { loop(); });
+        running = true;
+        std::cout << "[INFO] Render thread started" << std::endl;
+    }
+
+    void RenderThread::stop() {
+        if (!running) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        cv.notify_all();
+        thread.join();
+        running = false;
+        glfwMakeContextCurrent(window);
+        std::cout << "[INFO] Render thread stopped" << std::endl;
+    }
+
+    FramePacket& RenderThread::acquire() {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return executingIndex != writeIndex && queuedIndex != writeIndex; });
+        stats.waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        FramePacket& packet = packets[writeIndex];
+        packet.reset();
+        return packet;
+    }
+
+    void RenderThread::submit(bool sync) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        // The other packet may still be queued if the render thread has not
+        // picked it up yet; only one packet waits at a time.
+        cv.wait(lock, [this]() { return queuedIndex < 0; });
+        queuedIndex = writeIndex;
+        writeIndex ^= 1;
+        cv.notify_all();
+
+        if (sync) {
+            cv.wait(lock, [this]() { return queuedIndex < 0 && executingIndex < 0; });
+        }
+        stats.waitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    RenderThread::Stats RenderThread::getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    void RenderThread::loop() {
+        glfwMakeContextCurrent(window);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [this]() { return queuedIndex >= 0 || stopRequested; });
+            if (queuedIndex < 0) break; // stop requested and nothing left to draw
+
+            executingIndex = queuedIndex;
+            queuedIndex = -1;
+            cv.notify_all();
+            lock.unlock();
+
+            auto start = std::chrono::steady_clock::now();
+            packets[executingIndex].execute();
+            glfwSwapBuffers(window);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            lock.lock();
+            stats.executeMs = ms;
+            executingIndex = -1;
+            cv.notify_all();
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    }
+
+}
@@ -0,0 +1,255 @@
+#include "../headers/SceneLoader.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace Chained {
+
+    namespace {
+
+        struct Span {
+            size_t begin = 0;
+            size_t end = 0; // one past the last character
+        };
+
+        size_t skipWhitespace(const std::string& t, size_t i) {
+            while (i < t.size() && (t[i] == ' ' || t[i] == '\n' || t[i] == '\r' || t[i] == '\t')) ++i;
+            return i;
+        }
+
+        // i points at the opening quote; returns the index just past the closing one.
+        size_t skipString(const std::string& t, size_t i) {
+            for (++i; i < t.size(); ++i) {
+                if (t[i] == '\\') { ++i; continue; }
+                if (t[i] == '"') return i + 1;
+            }
+            return t.size();
+        }
+
+        // i points at '[' or '{'; returns the index of the matching bracket.
+        size_t matchBracket(const std::string& t, size_t i) {
+            int depth = 0;
+            while (i < t.size()) {
+                char c = t[i];
+                if (c == '"') { i = skipString(t, i); continue; }
+                if (c == '{' || c == '[') ++depth;
+                else if (c == '}' || c == ']') {
+                    if (--depth == 0) return i;
+                }
+                ++i;
+            }
+            return std::string::npos;
+        }
+
+        // Finds the root-level "objects" array without building a DOM for it.
+        bool findObjectsArray(const std::string& t, Span& arr) {
+            int depth = 0;
+            size_t i = 0;
+            while (i < t.size()) {
+                char c = t[i];
+                if (c == '"') {
+                    size_t end = skipString(t, i);
+                    if (depth == 1 && end - i == 9 && t.compare(i, 9, "\"objects\"") == 0) {
+                        size_t j = skipWhitespace(t, end);
+                        if (j < t.size() && t[j] == ':') {
+                            j = skipWhitespace(t, j + 1);
+                            if (j < t.size() && t[j] == '[') {
+                                size_t close = matchBracket(t, j);
+                                if (close == std::string::npos) return false;
+                                arr = { j, close + 1 };
+                                return true;
+                            }
+                        }
+                    }
+                    i = end;
+                    continue;
+                }
+                if (c == '{' || c == '[') ++depth;
+                else if (c == '}' || c == ']') --depth;
+                ++i;
+            }
+            return false;
+        }
+
+        // Splits the array text into one span per top-level element.
+        std::vector<Span> splitElements(const std::string& t, const Span& arr) {
+            std::vector<Span> elements;
+            int depth = 0;
+            size_t start = skipWhitespace(t, arr.begin + 1);
+            size_t last = arr.end - 1; // the closing ']'
+            size_t i = start;
+            while (i < last) {
+                char c = t[i];
+                if (c == '"') { i = skipString(t, i); continue; }
+                if (c == '{' || c == '[') ++depth;
+                else if (c == '}' || c == ']') --depth;
+                else if (c == ',' && depth == 0) {
+                    elements.push_back({ start, i });
+                    start = skipWhitespace(t, i + 1);
+                }
+                ++i;
+            }
+            if (skipWhitespace(t, start) < last) {
+                elements.push_back({ start, last });
+            }
+            return elements;
+        }
+
+    } // namespace
+
+    void SceneLoader::parseObject(const json& objJson, SceneObject& obj) {
+        obj.name = objJson["name"].get<std::string>();
+        obj.position = { objJson["position"][0].get<float>(), objJson["position"][1].get<float>() };
+        obj.rotation = objJson["rotation"].get<float>();
+        obj.scale = { objJson["scale"][0].get<float>(), objJson["scale"][1].get<float>() };
+        obj.assetId = objJson["assetId"].get<int>();
+        if (objJson.contains("physics")) {
+            const auto& phys = objJson["physics"];
+            obj.physics.enabled = phys.value("enabled", false);
+            obj.physics.bodyType = (Chained::BodyType)phys.value("bodyType", 0);
+            obj.physics.shapeType = (Chained::ShapeType)phys.value("shapeType", 0);
+            obj.physics.gravityScale = phys.value("gravityScale", 1.0f);
+            obj.physics.linearDamping = phys.value("linearDamping", 0.0f);
+            obj.physics.angularDamping = phys.value("angularDamping", 0.0f);
+            obj.physics.fixedRotation = phys.value("fixedRotation", false);
+            obj.physics.isSensor = phys.value("isSensor", false);
+            obj.physics.categoryBits = phys.value("categoryBits", uint16_t(0x0001));
+            obj.physics.maskBits = phys.value("maskBits", uint16_t(0xFFFF));
+            obj.physics.groupIndex = phys.value("groupIndex", int16_t(0));
+            obj.physics.material.friction = phys.value("friction", 0.5f);
+            obj.physics.material.bounciness = phys.value("bounciness", 0.0f);
+            obj.physics.material.density = phys.value("density", 1.0f);
+            if (phys.contains("size")) {
+                obj.physics.size = { phys["size"][0].get<float>(), phys["size"][1].get<float>() };
+            }
+            obj.physics.radius = phys.value("radius", 0.5f);
+        }
+    }
+
+    json SceneLoader::serializeObject(const SceneObject& obj) {
+        return {
+            {"name", obj.name},
+            {"position", {obj.position.x, obj.position.y}},
+            {"rotation", obj.rotation},
+            {"scale", {obj.scale.x, obj.scale.y}},
+            {"assetId", obj.assetId},
+            {"physics", {
+                {"enabled", obj.physics.enabled},
+                {"bodyType", (int)obj.physics.bodyType},
+                {"shapeType", (int)obj.physics.shapeType},
+                {"size", {obj.physics.size.x, obj.physics.size.y}},
+                {"radius", obj.physics.radius},
+                {"density", obj.physics.material.density},
+                {"friction", obj.physics.material.friction},
+                {"bounciness", obj.physics.material.bounciness},
+                {"gravityScale", obj.physics.gravityScale},
+                {"linearDamping", obj.physics.linearDamping},
+                {"angularDamping", obj.physics.angularDamping},
+                {"fixedRotation", obj.physics.fixedRotation},
+                {"isSensor", obj.physics.isSensor},
+                {"categoryBits", obj.physics.categoryBits},
+                {"maskBits", obj.physics.maskBits},
+                {"groupIndex", obj.physics.groupIndex}
+            }}
+        };
+    }
+
+    bool SceneLoader::loadFile(const std::string& filename, SceneData& out, const RangeReadyFn& onRangeReady, JobSystem* jobs) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "[ERROR] Could not open scene file: " << filename << std::endl;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return loadText(buffer.str(), out, onRangeReady, jobs);
+    }
+
+    bool SceneLoader::loadText(const std::string& text, SceneData& out, const RangeReadyFn& onRangeReady, JobSystem* jobs) {
+        out.objects.clear();
+
+        Span arr;
+        std::vector<Span> elements;
+        try {
+            if (findObjectsArray(text, arr)) {
+                // Parse the small remainder of the file with the array emptied out.
+                std::string rest;
+                rest.reserve(text.size() - (arr.end - arr.begin) + 2);
+                rest.append(text, 0, arr.begin).append("[]").append(text, arr.end, std::string::npos);
+                out.document = json::parse(rest);
+                elements = splitElements(text, arr);
+            }
+            else {
+                out.document = json::parse(text);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] Could not parse scene: " << e.what() << std::endl;
+            return false;
+        }
+
+        const size_t count = elements.size();
+        if (count == 0) return true;
+
+        size_t workerCount = jobs ? jobs->workerCount() : 1;
+        size_t perRange = std::max(MIN_OBJECTS_PER_RANGE, (count + workerCount * 4 - 1) / (workerCount * 4));
+        size_t rangeCount = (count + perRange - 1) / perRange;
+
+        // Every range writes into its own slots, so the merge keeps file order.
+        out.objects.resize(count);
+
+        std::atomic<bool> failed{ false };
+        auto buildRange = [&](size_t r) {
+            size_t first = r * perRange;
+            size_t last = std::min(count, first + perRange);
+            try {
+                for (size_t i = first; i < last; ++i) {
+                    json objJson = json::parse(text.begin() + elements[i].begin, text.begin() + elements[i].end);
+                    auto obj = std::make_unique<SceneObject>();
+                    parseObject(objJson, *obj);
+                    out.objects[i] = std::move(obj);
+                }
+            }
+            catch (const std::exception& e) {
+                std::cerr << "[ERROR] Could not parse scene object range " << r << ": " << e.what() << std::endl;
+                failed = true;
+            }
+        };
+
+        std::vector<JobHandle> handles(rangeCount);
+        if (jobs) {
+            for (size_t r = 0; r < rangeCount; ++r) {
+                handles[r] = jobs->schedule([&buildRange, r]() { buildRange(r); });
+            }
+        }
+
+        // Hand ranges to the caller in order; wait() runs other ranges on this
+        // thread while the next one is still pending.
+        for (size_t r = 0; r < rangeCount; ++r) {
+            if (jobs) jobs->wait(handles[r]);
+            else buildRange(r);
+            if (failed) break;
+            if (onRangeReady) {
+                auto first = out.objects.begin() + r * perRange;
+                auto last = out.objects.begin() + std::min(count, (r + 1) * perRange);
+                onRangeReady(first, last);
+            }
+        }
+
+        // The jobs reference this frame's locals; none may outlive it.
+        if (jobs) {
+            for (const JobHandle& handle : handles) jobs->wait(handle);
+        }
+
+        if (failed) {
+            out.objects.clear();
+            return false;
+        }
+        return true;
+    }
+
+}
@@ -1,12 +1,36 @@
 #include "../headers/SpriteAtlas.h"
 #include "../headers/resourceManager.h"
 #include "../headers/types.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
 
 using namespace Chained;
 
-SpriteAtlas::SpriteAtlas(const std::string& jsonFile) {
+namespace {
+    // Aseprite's hash format names frames "<file> <n>.<ext>", and JSON objects
+    // come back sorted by key, so "10" would precede "2". The last number in
+    // the name restores timeline order.
+    int frameNumber(const std::string& name) {
+        int end = int(name.size());
+        while (end > 0 && !std::isdigit(static_cast<unsigned char>(name[end - 1]))) --end;
+        int begin = end;
+        while (begin > 0 && std::isdigit(static_cast<unsigned char>(name[begin - 1]))) --begin;
+        return begin < end ? std::stoi(name.substr(begin, end - begin)) : -1;
+    }
+
+    TagDirection tagDirection(const std::string& direction) {
+        if (direction == "reverse") return TagDirection::Reverse;
+        if (direction == "pingpong") return TagDirection::PingPong;
+        if (direction == "pingpong_reverse") return TagDirection::PingPongReverse;
+        return TagDirection::Forward;
+    }
+}
+
+SpriteAtlas::SpriteAtlas(const std::string& jsonFile, JobSystem* jobs) {
     std::ifstream file(jsonFile);
     if (!file.is_open()) {
         std::cerr << "[ERROR] Could not open Aseprite JSON: " << jsonFile << "\n";
@@ -21,9 +45,19 @@ SpriteAtlas::SpriteAtlas(const std::string& jsonFile) {
     int atlasH = meta["size"]["h"];
     std::string imageFile = meta["image"];
 
-    m_texture = Chained::ResourceManager::get()->loadTexture(imageFile.c_str(), true, imageFile);
+    auto* rm = Chained::ResourceManager::get();
+    // Shared with the decode job, so a parse error that unwinds this frame
+    // before the wait below cannot leave the job writing into it.
+    auto decoded = std::make_shared<ResourceManager::DecodedImage>();
+    ResourceManager::DecodedImage& image = *decoded;
+    JobHandle decode;
+    if (jobs) {
+        decode = jobs->schedule([rm, decoded, imageFile]() { rm->decodeImage(imageFile, *decoded); });
+    }
 
-    // Load all frames
+    // Load all frames. The array format is already in timeline order.
+    const bool frameArray = j["frames"].is_array();
+    std::vector<std::pair<int, std::string>> frameOrder;
     for (auto& [frameName, frameData] : j["frames"].items()) {
         auto frame = frameData["frame"];
         float x = frame["x"];
@@ -39,9 +73,37 @@ SpriteAtlas::SpriteAtlas(const std::string& jsonFile) {
         );
 
         m_frames[frameName] = { uv, frameData["duration"] };
+        frameOrder.emplace_back(frameArray ? int(frameOrder.size()) : frameNumber(frameName), frameName);
+    }
+    std::stable_sort(frameOrder.begin(), frameOrder.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [order, frameName] : frameOrder) {
+        const AtlasFrame& frame = m_frames[frameName];
+        glm::vec4 flipped = frame.uvRect;
+        flipped.y = 1.0f - frame.uvRect.y - frame.uvRect.w;
+        m_frameInfos.push_back({ flipped, glm::vec2(frame.uvRect.z * atlasW, frame.uvRect.w * atlasH) });
+        m_frameDurations.push_back(frame.duration);
+    }
+
+    for (const auto& tag : meta["frameTags"]) {
+        FrameTag frameTag;
+        frameTag.name = tag.value("name", std::string());
+        frameTag.from = tag.value("from", 0);
+        frameTag.to = tag.value("to", 0);
+        frameTag.direction = tagDirection(tag.value("direction", std::string("forward")));
+        // Aseprite writes the repeat count as a string.
+        if (tag.contains("repeat")) {
+            frameTag.repeat = tag["repeat"].is_string() ? std::atoi(tag["repeat"].get<std::string>().c_str()) : tag["repeat"].get<int>();
+        }
+        if (frameTag.from < 0 || frameTag.to >= int(m_frameInfos.size()) || frameTag.from > frameTag.to) {
+            std::cerr << "[ERROR] Frame tag '" << frameTag.name << "' is out of range in " << jsonFile << std::endl;
+            continue;
+        }
+        m_frameTags.push_back(frameTag);
     }
 
     // Load slices
+    std::vector<glm::ivec4> sliceBounds; // pixels, by handle
     for (auto& slice : j["meta"]["slices"]) {
         std::string name = slice["name"];
         if (name.empty()) continue; // Skip unnamed slices
@@ -63,7 +125,57 @@ SpriteAtlas::SpriteAtlas(const std::string& jsonFile) {
                   << ") UV: (" << uv.x << ", " << uv.y << ", " << uv.z << ", " << uv.w << ")\n";
         
         m_slices[name] = { uv, 0 };
+
+        glm::vec4 flipped = uv;
+        flipped.y = 1.0f - uv.y - uv.w;
+        auto [it, inserted] = m_sliceHandles.emplace(name, static_cast<SliceHandle>(m_sliceInfos.size()));
+        if (inserted) {
+            m_sliceInfos.push_back({ flipped, glm::vec2(w, h) });
+            sliceBounds.emplace_back(int(x), int(y), int(w), int(h));
+        }
+        else {
+            m_sliceInfos[it->second] = { flipped, glm::vec2(w, h) };
+            sliceBounds[it->second] = glm::ivec4(int(x), int(y), int(w), int(h));
+        }
+    }
+
+    if (jobs) {
+        jobs->wait(decode);
     }
+    else {
+        rm->decodeImage(imageFile, image);
+    }
+
+    // Trace collision shapes while the pixels are still on the CPU; the upload
+    // below frees them.
+    m_sliceShapes.resize(m_sliceInfos.size());
+    if (image.pixels && image.channels == 4) {
+        const size_t stride = size_t(image.width) * 4;
+        auto traceRange = [this, &image, &sliceBounds, stride](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                glm::ivec4 b = sliceBounds[i];
+                // Bounds are top-down; the image was decoded bottom-up.
+                int bottom = image.height - (b.y + b.w);
+                if (b.x < 0 || bottom < 0 || b.x + b.z > image.width || b.w <= 0 || b.z <= 0) continue;
+                const uint8_t* origin = image.pixels + size_t(bottom) * stride + size_t(b.x) * 4;
+                m_sliceShapes[i] = buildAlphaShape(origin, b.z, b.w, stride);
+            }
+        };
+        if (jobs) {
+            jobs->wait(jobs->parallelFor(m_sliceShapes.size(), 1, traceRange));
+        }
+        else {
+            traceRange(0, m_sliceShapes.size());
+        }
+        for (const auto& [name, handle] : m_sliceHandles) {
+            if (m_sliceShapes[handle].approximated) {
+                std::cerr << "[ERROR] Slice " << name << " in " << imageFile
+                          << " has an outline that could not be split; its collider uses the outline's bounding box" << std::endl;
+            }
+        }
+    }
+
+    m_texture = rm->createTexture(image, true, imageFile);
 }
 
 Chained::Texture2DPtr SpriteAtlas::getTexture() const {
@@ -80,6 +192,11 @@ const AtlasFrame& SpriteAtlas::getSlice(const std::string& name) const {
     return m_slices.at(name);
 }
 
+SliceHandle SpriteAtlas::resolveSlice(const std::string& name) const {
+    auto it = m_sliceHandles.find(name);
+    return it != m_sliceHandles.end() ? it->second : InvalidSlice;
+}
+
 const std::unordered_map<std::string, AtlasFrame>& SpriteAtlas::getAllFrames() const {
     return m_frames;
 }
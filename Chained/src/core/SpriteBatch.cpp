@@ -0,0 +1,141 @@
+#include "../headers/SpriteBatch.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace Chained {
+
+    namespace {
+        // Bytes per sprite in each stream: 4 vertices of vec2 position, vec2 uv, RGBA8 color.
+        constexpr size_t PositionBytes = 4 * 2 * sizeof(float);
+        constexpr size_t UvBytes = 4 * 2 * sizeof(float);
+        constexpr size_t ColorBytes = 4 * sizeof(uint32_t);
+    }
+
+    SpriteBatch::SpriteBatch(ShaderPtr shader, size_t maxSpritesPerDraw)
+        : m_shader(shader), m_capacity(maxSpritesPerDraw) {
+        m_sprites.reserve(m_capacity);
+
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+        glGenBuffers(1, &m_ebo);
+
+        glBindVertexArray(m_vao);
+
+        // One buffer, three non-interleaved streams matching the kernel output.
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, m_capacity * (PositionBytes + UvBytes + ColorBytes), nullptr, GL_STREAM_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)(m_capacity * PositionBytes));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(uint32_t), (void*)(m_capacity * (PositionBytes + UvBytes)));
+
+        // Quad indices never change: 0-1-2, 2-3-0 for each sprite.
+        std::vector<GLuint> indices(m_capacity * 6);
+        for (size_t i = 0; i < m_capacity; ++i) {
+            GLuint base = static_cast<GLuint>(i * 4);
+            GLuint* idx = &indices[i * 6];
+            idx[0] = base + 0; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base + 2; idx[4] = base + 3; idx[5] = base + 0;
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        std::cout << "[INFO] SpriteBatch using " << simdLevelName(detectSimdLevel()) << " vertex kernel" << std::endl;
+    }
+
+    SpriteBatch::~SpriteBatch() {
+        glDeleteBuffers(1, &m_ebo);
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void SpriteBatch::begin(const glm::mat4& projection) {
+        m_shader->use();
+        m_shader->setUniform("projection", projection);
+        m_shader->setUniform("image", 0);
+        m_sprites.clear();
+        m_texture.reset();
+        m_drawCalls = 0;
+        m_spriteCount = 0;
+    }
+
+    void SpriteBatch::draw(const Texture2DPtr& texture, glm::vec2 position, glm::vec2 size,
+                           float rotate, glm::vec3 color, glm::vec4 uvRect, glm::vec2 scale) {
+        if (texture != m_texture) {
+            flush();
+            m_texture = texture;
+        }
+        m_sprites.push(position, size, rotate, scale, uvRect, packColor(color));
+    }
+
+    void SpriteBatch::end() {
+        flush();
+        m_texture.reset();
+    }
+
+    void SpriteBatch::submit(const glm::mat4& projection, const SpriteList& sprites, const Run* runs, size_t runCount) {
+        begin(projection);
+        for (size_t i = 0; i < runCount; ++i) {
+            drawRange(runs[i].texture, sprites, runs[i].first, runs[i].count);
+        }
+    }
+
+    void SpriteBatch::flush() {
+        drawRange(m_texture, m_sprites, 0, m_sprites.size());
+        m_sprites.clear();
+    }
+
+    void SpriteBatch::drawRange(const Texture2DPtr& texture, const SpriteList& sprites, size_t first, size_t count) {
+        if (count == 0 || !texture) return;
+
+        m_shader->use();
+        texture->bind();
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+        const size_t last = first + count;
+        for (size_t start = first; start < last; start += m_capacity) {
+            size_t chunk = std::min(m_capacity, last - start);
+
+            // Invalidate so the driver hands back fresh storage instead of
+            // stalling on the previous draw still reading this buffer.
+            void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, m_capacity * (PositionBytes + UvBytes + ColorBytes),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if (!mapped) {
+                std::cerr << "[ERROR] SpriteBatch could not map vertex buffer" << std::endl;
+                break;
+            }
+            char* base = static_cast<char*>(mapped);
+            SpriteVertexStreams out{
+                reinterpret_cast<float*>(base),
+                reinterpret_cast<float*>(base + m_capacity * PositionBytes),
+                reinterpret_cast<uint32_t*>(base + m_capacity * (PositionBytes + UvBytes))
+            };
+            if (m_jobs && chunk >= VERTEX_GRAIN * 2) {
+                m_jobs->wait(m_jobs->parallelFor(chunk, VERTEX_GRAIN, [&sprites, out, start](size_t begin, size_t end) {
+                    SpriteVertexStreams range{ out.positions + begin * 8, out.uvs + begin * 8, out.colors + begin * 4 };
+                    generateSpriteVertices(sprites, start + begin, end - begin, range);
+                }));
+            }
+            else {
+                generateSpriteVertices(sprites, start, chunk, out);
+            }
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(chunk * 6), GL_UNSIGNED_INT, nullptr);
+            ++m_drawCalls;
+        }
+        m_spriteCount += count;
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+}
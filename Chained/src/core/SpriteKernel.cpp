@@ -0,0 +1,388 @@
+#include "../headers/SpriteKernel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CH_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC lets any translation unit use AVX intrinsics; GCC and Clang need the
+// functions that use them tagged so the rest of the file stays SSE2-only.
+#if defined(CH_SIMD_X86) && !defined(_MSC_VER)
+#define CH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CH_TARGET_AVX2
+#endif
+
+namespace Chained {
+
+    void SpriteList::push(const glm::vec2& position, const glm::vec2& size, float rot,
+                          const glm::vec2& scale, const glm::vec4& uvRect, uint32_t rgba) {
+        x.push_back(position.x);
+        y.push_back(position.y);
+        width.push_back(size.x);
+        height.push_back(size.y);
+        scaleX.push_back(scale.x);
+        scaleY.push_back(scale.y);
+        rotation.push_back(rot);
+        u.push_back(uvRect.x);
+        v.push_back(uvRect.y);
+        uw.push_back(uvRect.z);
+        vh.push_back(uvRect.w);
+        color.push_back(rgba);
+        anyRotated |= rot != 0.0f;
+        anyScaled |= scale.x != 1.0f || scale.y != 1.0f;
+    }
+
+    void SpriteList::clear() {
+        x.clear(); y.clear();
+        width.clear(); height.clear();
+        scaleX.clear(); scaleY.clear();
+        rotation.clear();
+        u.clear(); v.clear(); uw.clear(); vh.clear();
+        color.clear();
+        anyRotated = false;
+        anyScaled = false;
+    }
+
+    void SpriteList::reserve(size_t count) {
+        x.reserve(count); y.reserve(count);
+        width.reserve(count); height.reserve(count);
+        scaleX.reserve(count); scaleY.reserve(count);
+        rotation.reserve(count);
+        u.reserve(count); v.reserve(count); uw.reserve(count); vh.reserve(count);
+        color.reserve(count);
+    }
+
+    void SpriteList::resize(size_t count) {
+        x.resize(count); y.resize(count);
+        width.resize(count); height.resize(count);
+        scaleX.resize(count, 1.0f); scaleY.resize(count, 1.0f);
+        rotation.resize(count);
+        u.resize(count); v.resize(count); uw.resize(count); vh.resize(count);
+        color.resize(count);
+    }
+
+    void SpriteList::copyTo(SpriteList& out, size_t at) const {
+        std::copy(x.begin(), x.end(), out.x.begin() + at);
+        std::copy(y.begin(), y.end(), out.y.begin() + at);
+        std::copy(width.begin(), width.end(), out.width.begin() + at);
+        std::copy(height.begin(), height.end(), out.height.begin() + at);
+        std::copy(scaleX.begin(), scaleX.end(), out.scaleX.begin() + at);
+        std::copy(scaleY.begin(), scaleY.end(), out.scaleY.begin() + at);
+        std::copy(rotation.begin(), rotation.end(), out.rotation.begin() + at);
+        std::copy(u.begin(), u.end(), out.u.begin() + at);
+        std::copy(v.begin(), v.end(), out.v.begin() + at);
+        std::copy(uw.begin(), uw.end(), out.uw.begin() + at);
+        std::copy(vh.begin(), vh.end(), out.vh.begin() + at);
+        std::copy(color.begin(), color.end(), out.color.begin() + at);
+        out.anyRotated |= anyRotated;
+        out.anyScaled |= anyScaled;
+    }
+
+    uint32_t packColor(const glm::vec3& color, float alpha) {
+        auto channel = [](float c) { return uint32_t(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+        return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (channel(alpha) << 24);
+    }
+
+    namespace {
+
+        using KernelFn = void (*)(const SpriteList&, size_t, size_t, const SpriteVertexStreams&);
+
+        // ---- Scalar reference, also used for the tail of the SIMD paths ----
+
+        template<bool Rotated, bool Scaled>
+        void kernelScalar(const SpriteList& l, size_t first, size_t count, const SpriteVertexStreams& out) {
+            for (size_t k = 0; k < count; ++k) {
+                size_t i = first + k;
+                float w = l.width[i], h = l.height[i];
+                if constexpr (Scaled) {
+                    w *= l.scaleX[i];
+                    h *= l.scaleY[i];
+                }
+
+                float* p = out.positions + k * 8;
+                if constexpr (Rotated) {
+                    float hw = 0.5f * w, hh = 0.5f * h;
+                    float cx = l.x[i] + hw, cy = l.y[i] + hh;
+                    float c = std::cos(l.rotation[i]), s = std::sin(l.rotation[i]);
+                    // Half extents along the rotated x and y axes.
+                    float ax = hw * c, ay = hw * s;
+                    float bx = -hh * s, by = hh * c;
+                    p[0] = cx - ax - bx; p[1] = cy - ay - by;
+                    p[2] = cx + ax - bx; p[3] = cy + ay - by;
+                    p[4] = cx + ax + bx; p[5] = cy + ay + by;
+                    p[6] = cx - ax + bx; p[7] = cy - ay + by;
+                }
+                else {
+                    float x0 = l.x[i], y0 = l.y[i], x1 = x0 + w, y1 = y0 + h;
+                    p[0] = x0; p[1] = y0;
+                    p[2] = x1; p[3] = y0;
+                    p[4] = x1; p[5] = y1;
+                    p[6] = x0; p[7] = y1;
+                }
+
+                float* t = out.uvs + k * 8;
+                float u0 = l.u[i], v0 = l.v[i], u1 = u0 + l.uw[i], v1 = v0 + l.vh[i];
+                t[0] = u0; t[1] = v0;
+                t[2] = u1; t[3] = v0;
+                t[4] = u1; t[5] = v1;
+                t[6] = u0; t[7] = v1;
+
+                uint32_t* c = out.colors + k * 4;
+                c[0] = c[1] = c[2] = c[3] = l.color[i];
+            }
+        }
+
+#ifdef CH_SIMD_X86
+
+        // ---- SSE2: four sprites per iteration ----
+
+        // Lanes hold one corner of four sprites; transpose to sprite-major
+        // x,y pairs so each sprite's four corners land in 8 contiguous floats.
+        inline void storeCorners4(float* dst, __m128 x0, __m128 y0, __m128 x1, __m128 y1,
+                                  __m128 x2, __m128 y2, __m128 x3, __m128 y3) {
+            __m128 a0l = _mm_unpacklo_ps(x0, y0), a0h = _mm_unpackhi_ps(x0, y0);
+            __m128 a1l = _mm_unpacklo_ps(x1, y1), a1h = _mm_unpackhi_ps(x1, y1);
+            __m128 a2l = _mm_unpacklo_ps(x2, y2), a2h = _mm_unpackhi_ps(x2, y2);
+            __m128 a3l = _mm_unpacklo_ps(x3, y3), a3h = _mm_unpackhi_ps(x3, y3);
+
+            _mm_storeu_ps(dst + 0, _mm_movelh_ps(a0l, a1l));
+            _mm_storeu_ps(dst + 4, _mm_movelh_ps(a2l, a3l));
+            _mm_storeu_ps(dst + 8, _mm_movehl_ps(a1l, a0l));
+            _mm_storeu_ps(dst + 12, _mm_movehl_ps(a3l, a2l));
+            _mm_storeu_ps(dst + 16, _mm_movelh_ps(a0h, a1h));
+            _mm_storeu_ps(dst + 20, _mm_movelh_ps(a2h, a3h));
+            _mm_storeu_ps(dst + 24, _mm_movehl_ps(a1h, a0h));
+            _mm_storeu_ps(dst + 28, _mm_movehl_ps(a3h, a2h));
+        }
+
+        template<bool Rotated, bool Scaled>
+        void kernelSSE2(const SpriteList& l, size_t first, size_t count, const SpriteVertexStreams& out) {
+            const __m128 half = _mm_set1_ps(0.5f);
+            size_t k = 0;
+            for (; k + 4 <= count; k += 4) {
+                size_t i = first + k;
+                __m128 x = _mm_loadu_ps(&l.x[i]);
+                __m128 y = _mm_loadu_ps(&l.y[i]);
+                __m128 w = _mm_loadu_ps(&l.width[i]);
+                __m128 h = _mm_loadu_ps(&l.height[i]);
+                if constexpr (Scaled) {
+                    w = _mm_mul_ps(w, _mm_loadu_ps(&l.scaleX[i]));
+                    h = _mm_mul_ps(h, _mm_loadu_ps(&l.scaleY[i]));
+                }
+
+                if constexpr (Rotated) {
+                    alignas(16) float cs[4], sn[4];
+                    for (int j = 0; j < 4; ++j) {
+                        cs[j] = std::cos(l.rotation[i + j]);
+                        sn[j] = std::sin(l.rotation[i + j]);
+                    }
+                    __m128 c = _mm_load_ps(cs), s = _mm_load_ps(sn);
+                    __m128 hw = _mm_mul_ps(w, half), hh = _mm_mul_ps(h, half);
+                    __m128 cx = _mm_add_ps(x, hw), cy = _mm_add_ps(y, hh);
+                    __m128 ax = _mm_mul_ps(hw, c), ay = _mm_mul_ps(hw, s);
+                    __m128 bx = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(hh, s)), by = _mm_mul_ps(hh, c);
+                    __m128 apbx = _mm_add_ps(ax, bx), apby = _mm_add_ps(ay, by);
+                    __m128 ambx = _mm_sub_ps(ax, bx), amby = _mm_sub_ps(ay, by);
+                    storeCorners4(out.positions + k * 8,
+                        _mm_sub_ps(cx, apbx), _mm_sub_ps(cy, apby),
+                        _mm_add_ps(cx, ambx), _mm_add_ps(cy, amby),
+                        _mm_add_ps(cx, apbx), _mm_add_ps(cy, apby),
+                        _mm_sub_ps(cx, ambx), _mm_sub_ps(cy, amby));
+                }
+                else {
+                    __m128 x1 = _mm_add_ps(x, w), y1 = _mm_add_ps(y, h);
+                    storeCorners4(out.positions + k * 8, x, y, x1, y, x1, y1, x, y1);
+                }
+
+                __m128 u0 = _mm_loadu_ps(&l.u[i]), v0 = _mm_loadu_ps(&l.v[i]);
+                __m128 u1 = _mm_add_ps(u0, _mm_loadu_ps(&l.uw[i]));
+                __m128 v1 = _mm_add_ps(v0, _mm_loadu_ps(&l.vh[i]));
+                storeCorners4(out.uvs + k * 8, u0, v0, u1, v0, u1, v1, u0, v1);
+
+                __m128i col = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&l.color[i]));
+                __m128i* cdst = reinterpret_cast<__m128i*>(out.colors + k * 4);
+                _mm_storeu_si128(cdst + 0, _mm_shuffle_epi32(col, 0x00));
+                _mm_storeu_si128(cdst + 1, _mm_shuffle_epi32(col, 0x55));
+                _mm_storeu_si128(cdst + 2, _mm_shuffle_epi32(col, 0xAA));
+                _mm_storeu_si128(cdst + 3, _mm_shuffle_epi32(col, 0xFF));
+            }
+
+            SpriteVertexStreams tail{ out.positions + k * 8, out.uvs + k * 8, out.colors + k * 4 };
+            kernelScalar<Rotated, Scaled>(l, first + k, count - k, tail);
+        }
+
+        // ---- AVX2: eight sprites per iteration ----
+
+        // p01/p23 hold corners 0-1 and 2-3 of sprite j in their low lane and of
+        // sprite j+4 in their high lane.
+        CH_TARGET_AVX2 inline void storeSpritePair(float* dst, int sprite, __m256 p01, __m256 p23) {
+            _mm256_storeu_ps(dst + sprite * 8, _mm256_permute2f128_ps(p01, p23, 0x20));
+            _mm256_storeu_ps(dst + (sprite + 4) * 8, _mm256_permute2f128_ps(p01, p23, 0x31));
+        }
+
+        // Same transpose as storeCorners4, but 256-bit unpack/shuffle work per
+        // 128-bit lane, so each register ends up holding half of sprite j and
+        // half of sprite j+4; permute2f128 stitches the halves together.
+        CH_TARGET_AVX2 inline void storeCorners8(float* dst, __m256 x0, __m256 y0, __m256 x1, __m256 y1,
+                                                 __m256 x2, __m256 y2, __m256 x3, __m256 y3) {
+            __m256 a0l = _mm256_unpacklo_ps(x0, y0), a0h = _mm256_unpackhi_ps(x0, y0);
+            __m256 a1l = _mm256_unpacklo_ps(x1, y1), a1h = _mm256_unpackhi_ps(x1, y1);
+            __m256 a2l = _mm256_unpacklo_ps(x2, y2), a2h = _mm256_unpackhi_ps(x2, y2);
+            __m256 a3l = _mm256_unpacklo_ps(x3, y3), a3h = _mm256_unpackhi_ps(x3, y3);
+
+            storeSpritePair(dst, 0, _mm256_shuffle_ps(a0l, a1l, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(a2l, a3l, _MM_SHUFFLE(1, 0, 1, 0)));
+            storeSpritePair(dst, 1, _mm256_shuffle_ps(a0l, a1l, _MM_SHUFFLE(3, 2, 3, 2)), _mm256_shuffle_ps(a2l, a3l, _MM_SHUFFLE(3, 2, 3, 2)));
+            storeSpritePair(dst, 2, _mm256_shuffle_ps(a0h, a1h, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(a2h, a3h, _MM_SHUFFLE(1, 0, 1, 0)));
+            storeSpritePair(dst, 3, _mm256_shuffle_ps(a0h, a1h, _MM_SHUFFLE(3, 2, 3, 2)), _mm256_shuffle_ps(a2h, a3h, _MM_SHUFFLE(3, 2, 3, 2)));
+        }
+
+        template<bool Rotated, bool Scaled>
+        CH_TARGET_AVX2 void kernelAVX2(const SpriteList& l, size_t first, size_t count, const SpriteVertexStreams& out) {
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256i spread01 = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+            const __m256i spread23 = _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3);
+            const __m256i spread45 = _mm256_setr_epi32(4, 4, 4, 4, 5, 5, 5, 5);
+            const __m256i spread67 = _mm256_setr_epi32(6, 6, 6, 6, 7, 7, 7, 7);
+            size_t k = 0;
+            for (; k + 8 <= count; k += 8) {
+                size_t i = first + k;
+                __m256 x = _mm256_loadu_ps(&l.x[i]);
+                __m256 y = _mm256_loadu_ps(&l.y[i]);
+                __m256 w = _mm256_loadu_ps(&l.width[i]);
+                __m256 h = _mm256_loadu_ps(&l.height[i]);
+                if constexpr (Scaled) {
+                    w = _mm256_mul_ps(w, _mm256_loadu_ps(&l.scaleX[i]));
+                    h = _mm256_mul_ps(h, _mm256_loadu_ps(&l.scaleY[i]));
+                }
+
+                if constexpr (Rotated) {
+                    alignas(32) float cs[8], sn[8];
+                    for (int j = 0; j < 8; ++j) {
+                        cs[j] = std::cos(l.rotation[i + j]);
+                        sn[j] = std::sin(l.rotation[i + j]);
+                    }
+                    __m256 c = _mm256_load_ps(cs), s = _mm256_load_ps(sn);
+                    __m256 hw = _mm256_mul_ps(w, half), hh = _mm256_mul_ps(h, half);
+                    __m256 cx = _mm256_add_ps(x, hw), cy = _mm256_add_ps(y, hh);
+                    __m256 ax = _mm256_mul_ps(hw, c), ay = _mm256_mul_ps(hw, s);
+                    __m256 bx = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(hh, s)), by = _mm256_mul_ps(hh, c);
+                    __m256 apbx = _mm256_add_ps(ax, bx), apby = _mm256_add_ps(ay, by);
+                    __m256 ambx = _mm256_sub_ps(ax, bx), amby = _mm256_sub_ps(ay, by);
+                    storeCorners8(out.positions + k * 8,
+                        _mm256_sub_ps(cx, apbx), _mm256_sub_ps(cy, apby),
+                        _mm256_add_ps(cx, ambx), _mm256_add_ps(cy, amby),
+                        _mm256_add_ps(cx, apbx), _mm256_add_ps(cy, apby),
+                        _mm256_sub_ps(cx, ambx), _mm256_sub_ps(cy, amby));
+                }
+                else {
+                    __m256 x1 = _mm256_add_ps(x, w), y1 = _mm256_add_ps(y, h);
+                    storeCorners8(out.positions + k * 8, x, y, x1, y, x1, y1, x, y1);
+                }
+
+                __m256 u0 = _mm256_loadu_ps(&l.u[i]), v0 = _mm256_loadu_ps(&l.v[i]);
+                __m256 u1 = _mm256_add_ps(u0, _mm256_loadu_ps(&l.uw[i]));
+                __m256 v1 = _mm256_add_ps(v0, _mm256_loadu_ps(&l.vh[i]));
+                storeCorners8(out.uvs + k * 8, u0, v0, u1, v0, u1, v1, u0, v1);
+
+                __m256i col = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&l.color[i]));
+                __m256i* cdst = reinterpret_cast<__m256i*>(out.colors + k * 4);
+                _mm256_storeu_si256(cdst + 0, _mm256_permutevar8x32_epi32(col, spread01));
+                _mm256_storeu_si256(cdst + 1, _mm256_permutevar8x32_epi32(col, spread23));
+                _mm256_storeu_si256(cdst + 2, _mm256_permutevar8x32_epi32(col, spread45));
+                _mm256_storeu_si256(cdst + 3, _mm256_permutevar8x32_epi32(col, spread67));
+            }
+
+            SpriteVertexStreams tail{ out.positions + k * 8, out.uvs + k * 8, out.colors + k * 4 };
+            kernelSSE2<Rotated, Scaled>(l, first + k, count - k, tail);
+        }
+
+#endif // CH_SIMD_X86
+
+        KernelFn pickKernel(SimdLevel level, bool rotated, bool scaled) {
+#ifdef CH_SIMD_X86
+            if (level == SimdLevel::AVX2) {
+                if (rotated) return scaled ? &kernelAVX2<true, true> : &kernelAVX2<true, false>;
+                return scaled ? &kernelAVX2<false, true> : &kernelAVX2<false, false>;
+            }
+            if (level == SimdLevel::SSE2) {
+                if (rotated) return scaled ? &kernelSSE2<true, true> : &kernelSSE2<true, false>;
+                return scaled ? &kernelSSE2<false, true> : &kernelSSE2<false, false>;
+            }
+#endif
+            if (rotated) return scaled ? &kernelScalar<true, true> : &kernelScalar<true, false>;
+            return scaled ? &kernelScalar<false, true> : &kernelScalar<false, false>;
+        }
+
+    }
+
+    SimdLevel detectSimdLevel() {
+#ifdef CH_SIMD_X86
+        unsigned int regs[4] = {};
+        auto cpuid = [&regs](unsigned int leaf, unsigned int sub) {
+#if defined(_MSC_VER)
+            int r[4];
+            __cpuidex(r, int(leaf), int(sub));
+            for (int j = 0; j < 4; ++j) regs[j] = unsigned(r[j]);
+#else
+            __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        };
+
+        cpuid(0, 0);
+        unsigned int maxLeaf = regs[0];
+        cpuid(1, 0);
+        bool sse2 = (regs[3] >> 26) & 1;
+        bool osxsave = (regs[2] >> 27) & 1;
+        bool avx = (regs[2] >> 28) & 1;
+
+        bool avx2 = false;
+        if (osxsave && avx && maxLeaf >= 7) {
+            // The OS has to save the YMM registers on context switch too.
+#if defined(_MSC_VER)
+            unsigned long long xcr0 = _xgetbv(0);
+#else
+            unsigned int lo, hi;
+            __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            unsigned long long xcr0 = (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+            if ((xcr0 & 0x6) == 0x6) {
+                cpuid(7, 0);
+                avx2 = (regs[1] >> 5) & 1;
+            }
+        }
+
+        if (avx2) return SimdLevel::AVX2;
+        if (sse2) return SimdLevel::SSE2;
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    const char* simdLevelName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+
+    void generateSpriteVertices(const SpriteList& list, size_t first, size_t count,
+                                const SpriteVertexStreams& out) {
+        static const SimdLevel detected = detectSimdLevel();
+        generateSpriteVertices(list, first, count, out, detected);
+    }
+
+    void generateSpriteVertices(const SpriteList& list, size_t first, size_t count,
+                                const SpriteVertexStreams& out, SimdLevel level) {
+        if (count == 0) return;
+        pickKernel(level, list.anyRotated, list.anyScaled)(list, first, count, out);
+    }
+
+}
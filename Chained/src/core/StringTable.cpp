@@ -0,0 +1,24 @@
+#include "../headers/StringTable.h"
+
+namespace Chained {
+
+    StringId StringTable::intern(const std::string& str) {
+        auto it = lookup.find(str);
+        if (it != lookup.end()) return it->second;
+        StringId id = static_cast<StringId>(strings.size());
+        strings.push_back(str);
+        lookup.emplace(str, id);
+        return id;
+    }
+
+    StringId StringTable::find(const std::string& str) const {
+        auto it = lookup.find(str);
+        return it != lookup.end() ? it->second : InvalidStringId;
+    }
+
+    const std::string& StringTable::str(StringId id) const {
+        static const std::string empty;
+        return id < strings.size() ? strings[id] : empty;
+    }
+
+}
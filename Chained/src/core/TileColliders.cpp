@@ -0,0 +1,148 @@
+#include "../headers/TileColliders.h"
+#include "../headers/physics.h"
+#include <algorithm>
+
+namespace Chained {
+
+    void greedyMeshChunk(const TileMap::Chunk& chunk, const std::vector<uint8_t>& solid, std::vector<TileRect>& out) {
+        constexpr int N = TileMap::ChunkTiles;
+        // Solid and not yet covered.
+        uint8_t open[N][N];
+        for (int y = 0; y < N; ++y) {
+            for (int x = 0; x < N; ++x) {
+                open[y][x] = solid[chunk.at(x, y)];
+            }
+        }
+
+        for (int y = 0; y < N; ++y) {
+            for (int x = 0; x < N; ++x) {
+                if (!open[y][x]) continue;
+                int w = 1;
+                while (x + w < N && open[y][x + w]) ++w;
+                int h = 1;
+                for (; y + h < N; ++h) {
+                    bool full = true;
+                    for (int k = 0; k < w && full; ++k) full = open[y + h][x + k] != 0;
+                    if (!full) break;
+                }
+                for (int j = 0; j < h; ++j) {
+                    for (int k = 0; k < w; ++k) open[y + j][x + k] = 0;
+                }
+                out.push_back({ x, y, w, h });
+            }
+        }
+    }
+
+    TileColliderBuilder::TileColliderBuilder(Registry& registry, PhysicsSystem& physics)
+        : registry(registry), physics(physics), solid(size_t(TileMap::Empty) + 1, 0) {
+        settings.fixture.bodyType = BodyType::Static;
+    }
+
+    void TileColliderBuilder::setSolid(TileId id, bool value) {
+        if (id == TileMap::Empty || solid[id] == uint8_t(value)) return;
+        solid[id] = value ? 1 : 0;
+        rebuildAll = true;
+    }
+
+    void TileColliderBuilder::release(ChunkBody& body) {
+        fixtureCount -= body.rects.size();
+        for (const PartitionBody& part : body.owners) {
+            physics.removeEntity(part.owner);
+            registry.destroy(part.owner);
+        }
+        body.owners.clear();
+    }
+
+    void TileColliderBuilder::clear() {
+        for (auto& [key, body] : chunks) {
+            release(body);
+        }
+        chunks.clear();
+        fixtureCount = 0;
+        rebuildAll = true;
+    }
+
+    void TileColliderBuilder::rebuild(ChunkBody& body, int cx, int cy, const TileMap::Chunk& chunk) {
+        scratch.clear();
+        greedyMeshChunk(chunk, solid, scratch);
+
+        fixtureCount -= body.rects.size();
+        body.rects.clear();
+        const glm::vec2 base = settings.origin + glm::vec2(cx, cy) * (settings.tileSize * TileMap::ChunkTiles);
+        for (const TileRect& r : scratch) {
+            glm::vec2 min = base + glm::vec2(r.x, r.y) * settings.tileSize;
+            body.rects.push_back({ min, min + glm::vec2(r.w, r.h) * settings.tileSize });
+        }
+        fixtureCount += body.rects.size();
+
+        // Bucket rects by every partition they reach; a rect on a border is
+        // added to both sides so bodies in either world collide with it.
+        byPartition.resize(physics.getPartitionCount());
+        for (auto& rects : byPartition) rects.clear();
+        for (const MergeRect& rect : body.rects) {
+            reached.clear();
+            physics.partitionsOverlapping(rect.min, rect.max, reached);
+            for (PartitionId p : reached) byPartition[p].push_back(rect);
+        }
+
+        // Reuse the entity already holding each partition's body.
+        std::vector<PartitionBody> kept;
+        for (PartitionId p = 0; p < byPartition.size(); ++p) {
+            if (byPartition[p].empty()) continue;
+            auto it = std::find_if(body.owners.begin(), body.owners.end(), [p](const PartitionBody& b) { return b.partition == p; });
+            Entity owner = NullEntity;
+            if (it != body.owners.end()) {
+                owner = it->owner;
+                body.owners.erase(it);
+            }
+            if (!registry.alive(owner)) owner = registry.create();
+            physics.setStaticBoxes(owner, byPartition[p].data(), byPartition[p].size(), settings.fixture, p);
+            kept.push_back({ p, owner });
+        }
+        for (const PartitionBody& stale : body.owners) {
+            physics.removeEntity(stale.owner);
+            registry.destroy(stale.owner);
+        }
+        body.owners = std::move(kept);
+        body.revision = chunk.revision;
+    }
+
+    bool TileColliderBuilder::ownersAlive(const ChunkBody& body) const {
+        for (const PartitionBody& part : body.owners) {
+            if (!registry.alive(part.owner)) return false;
+        }
+        return true;
+    }
+
+    size_t TileColliderBuilder::sync(const TileMap& map) {
+        if (!rebuildAll && map.getRevision() == syncedRevision) return 0;
+        ++pass;
+
+        size_t rebuilt = 0;
+        map.forEachChunk(settings.layer, [&](int cx, int cy, const TileMap::Chunk& chunk) {
+            ChunkBody& body = chunks[TileMap::keyFor(cx, cy)];
+            body.seen = pass;
+            if (!rebuildAll && body.revision == chunk.revision && ownersAlive(body)) return;
+            rebuild(body, cx, cy, chunk);
+            ++rebuilt;
+        });
+
+        // Chunks erased from the map since the last pass.
+        for (auto it = chunks.begin(); it != chunks.end();) {
+            if (it->second.seen == pass) { ++it; continue; }
+            release(it->second);
+            it = chunks.erase(it);
+        }
+
+        syncedRevision = map.getRevision();
+        rebuildAll = false;
+        return rebuilt;
+    }
+
+    void TileColliderBuilder::collectRects(std::vector<MergeRect>& out) const {
+        for (const auto& [key, body] : chunks) {
+            out.insert(out.end(), body.rects.begin(), body.rects.end());
+        }
+    }
+
+}
@@ -0,0 +1,193 @@
+#include "../headers/TileMapRenderer.h"
+#include "../headers/Shader.h"
+#include "../headers/Texture2D.h"
+#include "../headers/types.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Chained {
+
+    namespace {
+        uint16_t packId(int id) {
+            return id < 0 || id >= TileMapRenderer::EmptyTile ? TileMapRenderer::EmptyTile : static_cast<uint16_t>(id);
+        }
+    }
+
+    TileMapRenderer::TileMapRenderer(ShaderPtr shader, int chunkTiles)
+        : m_shader(shader), m_chunkTiles(std::max(1, chunkTiles)) {
+        // Unit quad; the vertex shader scales it to the chunk.
+        const GLfloat vertices[] = {
+            0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+            0.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f,
+        };
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (void*)0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    TileMapRenderer::~TileMapRenderer() {
+        releaseChunks();
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void TileMapRenderer::releaseChunks() {
+        for (Chunk& chunk : m_chunks) {
+            if (chunk.texture) glDeleteTextures(1, &chunk.texture);
+        }
+        m_chunks.clear();
+    }
+
+    void TileMapRenderer::setMap(int width, int height, const int* ids) {
+        releaseChunks();
+        m_width = std::max(0, width);
+        m_height = std::max(0, height);
+        m_chunksX = (m_width + m_chunkTiles - 1) / m_chunkTiles;
+        m_chunksY = (m_height + m_chunkTiles - 1) / m_chunkTiles;
+        m_chunks.resize(size_t(m_chunksX) * m_chunksY);
+
+        // Chunks hanging over the map's edge keep EmptyTile outside it.
+        const size_t chunkArea = size_t(m_chunkTiles) * m_chunkTiles;
+        for (int cy = 0; cy < m_chunksY; ++cy) {
+            for (int cx = 0; cx < m_chunksX; ++cx) {
+                Chunk& chunk = m_chunks[size_t(cy) * m_chunksX + cx];
+                chunk.ids.assign(chunkArea, EmptyTile);
+                for (int ly = 0; ly < m_chunkTiles; ++ly) {
+                    int y = cy * m_chunkTiles + ly;
+                    if (y >= m_height) break;
+                    for (int lx = 0; lx < m_chunkTiles; ++lx) {
+                        int x = cx * m_chunkTiles + lx;
+                        if (x >= m_width) break;
+                        chunk.ids[size_t(ly) * m_chunkTiles + lx] = packId(ids ? ids[size_t(y) * m_width + x] : 0);
+                    }
+                }
+                chunk.dirtyMin = glm::ivec2(0);
+                chunk.dirtyMax = glm::ivec2(m_chunkTiles - 1);
+            }
+        }
+    }
+
+    TileMapRenderer::Chunk* TileMapRenderer::chunkAt(int x, int y, glm::ivec2& local) {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height) return nullptr;
+        local = { x % m_chunkTiles, y % m_chunkTiles };
+        return &m_chunks[size_t(y / m_chunkTiles) * m_chunksX + x / m_chunkTiles];
+    }
+
+    void TileMapRenderer::markDirty(Chunk& chunk, glm::ivec2 local) {
+        if (chunk.dirtyMax.x < chunk.dirtyMin.x) {
+            chunk.dirtyMin = chunk.dirtyMax = local;
+            return;
+        }
+        chunk.dirtyMin = glm::min(chunk.dirtyMin, local);
+        chunk.dirtyMax = glm::max(chunk.dirtyMax, local);
+    }
+
+    void TileMapRenderer::setTile(int x, int y, int id) {
+        glm::ivec2 local;
+        Chunk* chunk = chunkAt(x, y, local);
+        if (!chunk) return;
+        uint16_t& slot = chunk->ids[size_t(local.y) * m_chunkTiles + local.x];
+        uint16_t packed = packId(id);
+        if (slot == packed) return;
+        slot = packed;
+        markDirty(*chunk, local);
+    }
+
+    int TileMapRenderer::getTile(int x, int y) const {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height) return EmptyTile;
+        const Chunk& chunk = m_chunks[size_t(y / m_chunkTiles) * m_chunksX + x / m_chunkTiles];
+        return chunk.ids[size_t(y % m_chunkTiles) * m_chunkTiles + x % m_chunkTiles];
+    }
+
+    void TileMapRenderer::setTileset(Texture2DPtr tileset, int tilePixels, int columns) {
+        m_tileset = tileset;
+        m_tilePixels = std::max(1, tilePixels);
+        m_tilesetColumns = std::max(1, columns);
+    }
+
+    void TileMapRenderer::upload(Chunk& chunk) {
+        if (chunk.dirtyMax.x < chunk.dirtyMin.x) return;
+
+        if (!chunk.texture) {
+            // Integer textures must be sampled with nearest filtering.
+            glGenTextures(1, &chunk.texture);
+            glBindTexture(GL_TEXTURE_2D, chunk.texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, m_chunkTiles, m_chunkTiles, 0,
+                GL_RED_INTEGER, GL_UNSIGNED_SHORT, chunk.ids.data());
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            m_uploadedTiles += chunk.ids.size();
+        }
+        else {
+            // Just the dirty rectangle, read straight out of the chunk's ids.
+            glm::ivec2 size = chunk.dirtyMax - chunk.dirtyMin + 1;
+            glBindTexture(GL_TEXTURE_2D, chunk.texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_chunkTiles);
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, chunk.dirtyMin.x);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, chunk.dirtyMin.y);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, chunk.dirtyMin.x, chunk.dirtyMin.y, size.x, size.y,
+                GL_RED_INTEGER, GL_UNSIGNED_SHORT, chunk.ids.data());
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            m_uploadedTiles += size_t(size.x) * size.y;
+        }
+        chunk.dirtyMin = glm::ivec2(0);
+        chunk.dirtyMax = glm::ivec2(-1);
+    }
+
+    void TileMapRenderer::draw(const glm::mat4& projection, glm::vec2 origin, float tileSize,
+                               glm::vec2 viewMin, glm::vec2 viewMax) {
+        m_drawCalls = 0;
+        m_uploadedTiles = 0;
+        if (m_chunks.empty() || !m_tileset || tileSize <= 0.0f) return;
+
+        const float chunkSize = tileSize * m_chunkTiles;
+        glm::ivec2 first = glm::ivec2(glm::floor((glm::min(viewMin, viewMax) - origin) / chunkSize));
+        glm::ivec2 last = glm::ivec2(glm::floor((glm::max(viewMin, viewMax) - origin) / chunkSize));
+        first = glm::max(first, glm::ivec2(0));
+        last = glm::min(last, glm::ivec2(m_chunksX - 1, m_chunksY - 1));
+        if (last.x < first.x || last.y < first.y) return;
+
+        const int tileRows = std::max(1, int(m_tileset->m_height) / m_tilePixels);
+        m_shader->use();
+        m_shader->setUniform("projection", projection);
+        m_shader->setUniform("tileSize", tileSize);
+        m_shader->setUniform("chunkTiles", GLint(m_chunkTiles));
+        m_shader->setUniform("tilePixels", GLint(m_tilePixels));
+        m_shader->setUniform("tilesetColumns", GLint(m_tilesetColumns));
+        m_shader->setUniform("tileCount", GLint(m_tilesetColumns * tileRows));
+        m_shader->setUniform("tileIds", GLint(0));
+        m_shader->setUniform("tileset", GLint(1));
+
+        glActiveTexture(GL_TEXTURE1);
+        m_tileset->bind();
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(m_vao);
+        for (int cy = first.y; cy <= last.y; ++cy) {
+            for (int cx = first.x; cx <= last.x; ++cx) {
+                Chunk& chunk = m_chunks[size_t(cy) * m_chunksX + cx];
+                upload(chunk); // binds the chunk's texture when it has edits
+                glBindTexture(GL_TEXTURE_2D, chunk.texture);
+                m_shader->setUniform("chunkOrigin", origin + glm::vec2(cx, cy) * chunkSize);
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+                ++m_drawCalls;
+            }
+        }
+        glBindVertexArray(0);
+    }
+
+}
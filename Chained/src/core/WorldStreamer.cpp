@@ -0,0 +1,312 @@
+#include "../headers/WorldStreamer.h"
+#include "../headers/Camera.h"
+#include "../headers/FramePacket.h"
+#include "../headers/SpriteAtlas.h"
+#include "../headers/physics.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+using json = nlohmann::json;
+
+namespace Chained {
+
+    WorldStreamer::WorldStreamer(Registry& registry, PhysicsSystem& physics, JobSystem& jobs)
+        : registry(registry), physics(physics), jobs(jobs) {
+    }
+
+    WorldStreamer::~WorldStreamer() {
+        clear();
+    }
+
+    bool WorldStreamer::open(const json& worldJson) {
+        clear();
+        chunks.clear();
+        chunkIndex.clear();
+
+        chunkSize = worldJson.value("chunkSize", 2048.0f);
+        if (chunkSize <= 0.0f || !worldJson.contains("chunks")) {
+            std::cerr << "[ERROR] World manifest has no chunks" << std::endl;
+            return false;
+        }
+
+        chunks.reserve(worldJson["chunks"].size());
+        for (const auto& chunkJson : worldJson["chunks"]) {
+            Chunk chunk;
+            chunk.coord = { chunkJson["x"].get<int>(), chunkJson["y"].get<int>() };
+            chunk.file = chunkJson["file"].get<std::string>();
+            chunkIndex[keyFor(chunk.coord.x, chunk.coord.y)] = chunks.size();
+            chunks.push_back(std::move(chunk));
+        }
+        std::cout << "[INFO] World opened with " << chunks.size() << " chunks of " << chunkSize << "px" << std::endl;
+        return true;
+    }
+
+    void WorldStreamer::update(const Camera& camera, float dt) {
+        glm::vec2 camPos = camera.getPosition();
+        glm::vec2 viewSize = { camera.getViewportWidth() / camera.getZoom(), camera.getViewportHeight() / camera.getZoom() };
+
+        glm::vec2 velocity(0.0f);
+        if (hasLastCamera && dt > 0.0f) {
+            velocity = (camPos - lastCameraPos) / dt;
+        }
+        lastCameraPos = camPos;
+        hasLastCamera = true;
+
+        for (Chunk* chunk : loading) chunk->wanted = false;
+        for (Chunk* chunk : resident) chunk->wanted = false;
+
+        glm::vec2 margin(settings.loadMargin);
+        requestRange(camPos - margin, camPos + viewSize + margin);
+
+        glm::vec2 ahead = velocity * settings.prefetchSeconds;
+        if (ahead.x != 0.0f || ahead.y != 0.0f) {
+            requestRange(camPos + ahead - margin, camPos + ahead + viewSize + margin);
+        }
+
+        // Anything already in flight stays until it drifts past the unload margin,
+        // so a camera sitting on a chunk border does not thrash.
+        glm::vec2 keepMin = camPos - glm::vec2(settings.unloadMargin);
+        glm::vec2 keepMax = camPos + viewSize + glm::vec2(settings.unloadMargin);
+        auto keep = [&](Chunk* chunk) {
+            glm::vec2 lo = glm::vec2(chunk->coord) * chunkSize;
+            glm::vec2 hi = lo + glm::vec2(chunkSize);
+            if (lo.x < keepMax.x && hi.x > keepMin.x && lo.y < keepMax.y && hi.y > keepMin.y) {
+                chunk->wanted = true;
+                // A chunk partway through release rebuilds the bodies it has
+                // torn down so far and turns Resident again once they are back.
+                if (chunk->state == ChunkState::Releasing) chunk->state = ChunkState::Building;
+            }
+        };
+        for (Chunk* chunk : loading) keep(chunk);
+        for (Chunk* chunk : resident) keep(chunk);
+
+        pollLoads();
+
+        int budget = settings.bodyBudgetPerFrame;
+        releaseChunks(budget);
+        buildBodies(budget);
+    }
+
+    void WorldStreamer::requestRange(const glm::vec2& min, const glm::vec2& max) {
+        int x0 = (int)std::floor(min.x / chunkSize);
+        int y0 = (int)std::floor(min.y / chunkSize);
+        int x1 = (int)std::floor(max.x / chunkSize);
+        int y1 = (int)std::floor(max.y / chunkSize);
+
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                auto it = chunkIndex.find(keyFor(x, y));
+                if (it == chunkIndex.end()) continue;
+
+                Chunk& chunk = chunks[it->second];
+                chunk.wanted = true;
+                if (chunk.state == ChunkState::Unloaded) {
+                    Chunk* target = &chunk;
+                    JobSystem* system = &jobs;
+                    chunk.pending = jobs.scheduleBackground([target, system]() {
+                        target->loaded = {};
+                        SceneLoader::loadFile(target->file, target->loaded, nullptr, system);
+                    });
+                    chunk.state = ChunkState::Loading;
+                    loading.push_back(&chunk);
+                }
+                else if (chunk.state == ChunkState::Releasing) {
+                    chunk.state = ChunkState::Building;
+                }
+            }
+        }
+    }
+
+    void WorldStreamer::pollLoads() {
+        for (size_t i = 0; i < loading.size();) {
+            Chunk* chunk = loading[i];
+            if (!JobSystem::isDone(chunk->pending)) {
+                ++i;
+                continue;
+            }
+
+            chunk->pending.reset();
+            SceneLoader::SceneData data = std::move(chunk->loaded);
+            chunk->loaded = {};
+            if (chunk->wanted) {
+                chunk->entities.clear();
+                chunk->entities.reserve(data.objects.size());
+                for (const auto& obj : data.objects) {
+                    chunk->entities.push_back(registry.spawn(*obj));
+                }
+                bakeSprites(*chunk);
+                chunk->bodyCursor = 0;
+                chunk->state = ChunkState::Building;
+                resident.push_back(chunk);
+            }
+            else {
+                chunk->state = ChunkState::Unloaded;
+            }
+            loading[i] = loading.back();
+            loading.pop_back();
+        }
+    }
+
+    void WorldStreamer::bakeSprites(Chunk& chunk) {
+        // Entities without a moving body keep their pose, so their sprites
+        // are built once here. They keep the Sprite component (colliders and
+        // debug drawing read its slice) but are marked baked.
+        chunk.sprites.clear();
+        chunk.spriteMin = glm::vec2(INFINITY);
+        chunk.spriteMax = glm::vec2(-INFINITY);
+        const SpriteAtlas* atlas = registry.getAtlas();
+        if (!atlas) return;
+        const uint32_t white = packColor(glm::vec3(1.0f));
+        for (Entity e : chunk.entities) {
+            Sprite* sprite = registry.sprites.get(e);
+            const Transform* transform = registry.transforms.get(e);
+            if (!sprite || sprite->slice == InvalidSlice || !transform) continue;
+            const Collider* collider = registry.colliders.get(e);
+            if (collider && collider->desc.enabled && collider->desc.bodyType != BodyType::Static) continue;
+
+            const SliceInfo& slice = atlas->getSliceInfo(sprite->slice);
+            chunk.sprites.push(transform->position, slice.pixelSize, transform->rotation, transform->scale, slice.uvRect, white);
+            sprite->baked = true;
+
+            // Same bounds as the per-sprite cull.
+            glm::vec2 half = 0.5f * slice.pixelSize * transform->scale;
+            glm::vec2 center = transform->position + half;
+            if (transform->rotation != 0.0f) half = glm::vec2(glm::length(half));
+            chunk.spriteMin = glm::min(chunk.spriteMin, center - half);
+            chunk.spriteMax = glm::max(chunk.spriteMax, center + half);
+        }
+    }
+
+    void WorldStreamer::record(FramePacket& packet, const Texture2DPtr& texture, const glm::vec2& viewMin, const glm::vec2& viewMax) const {
+        for (const Chunk* chunk : resident) {
+            const size_t count = chunk->sprites.size();
+            if (count == 0) continue;
+            if (chunk->spriteMax.x < viewMin.x || chunk->spriteMin.x > viewMax.x ||
+                chunk->spriteMax.y < viewMin.y || chunk->spriteMin.y > viewMax.y) continue;
+            size_t first = 0;
+            SpriteList* out = packet.appendSprites(texture, count, first);
+            if (!out) return;
+            chunk->sprites.copyTo(*out, first);
+        }
+    }
+
+    void WorldStreamer::buildBodies(int& budget) {
+        for (Chunk* chunk : resident) {
+            if (chunk->state != ChunkState::Building) continue;
+            while (budget > 0 && chunk->bodyCursor < chunk->entities.size()) {
+                physics.addEntity(chunk->entities[chunk->bodyCursor++]);
+                --budget;
+            }
+            if (chunk->bodyCursor == chunk->entities.size()) {
+                chunk->state = ChunkState::Resident;
+            }
+            if (budget <= 0) return;
+        }
+    }
+
+    void WorldStreamer::releaseChunks(int& budget) {
+        for (size_t i = 0; i < resident.size();) {
+            Chunk* chunk = resident[i];
+            if (!chunk->wanted) {
+                chunk->state = ChunkState::Releasing;
+            }
+            if (chunk->state != ChunkState::Releasing) {
+                ++i;
+                continue;
+            }
+
+            // Bodies exist for entities [0, bodyCursor); tear them down from the back.
+            while (budget > 0 && chunk->bodyCursor > 0) {
+                physics.removeEntity(chunk->entities[--chunk->bodyCursor]);
+                --budget;
+            }
+            if (chunk->bodyCursor > 0) return;
+
+            for (Entity e : chunk->entities) {
+                registry.destroy(e);
+            }
+            std::vector<Entity>().swap(chunk->entities);
+            chunk->sprites = SpriteList();
+            chunk->state = ChunkState::Unloaded;
+            resident.erase(resident.begin() + i);
+        }
+    }
+
+    void WorldStreamer::clear() {
+        for (Chunk* chunk : loading) {
+            jobs.wait(chunk->pending);
+            chunk->pending.reset();
+            chunk->loaded = {};
+            chunk->state = ChunkState::Unloaded;
+        }
+        loading.clear();
+
+        for (Chunk* chunk : resident) {
+            while (chunk->bodyCursor > 0) {
+                physics.removeEntity(chunk->entities[--chunk->bodyCursor]);
+            }
+            for (Entity e : chunk->entities) {
+                registry.destroy(e);
+            }
+            chunk->entities.clear();
+            chunk->sprites = SpriteList();
+            chunk->state = ChunkState::Unloaded;
+        }
+        resident.clear();
+        hasLastCamera = false;
+    }
+
+    bool WorldStreamer::cookScene(const std::string& sceneFile, const std::string& manifestFile, float chunkSize, JobSystem* jobs) {
+        namespace fs = std::filesystem;
+
+        SceneLoader::SceneData scene;
+        if (!SceneLoader::loadFile(sceneFile, scene, nullptr, jobs)) return false;
+
+        // std::map keeps the manifest ordered by chunk coordinate.
+        std::map<std::pair<int, int>, json> buckets;
+        for (const auto& obj : scene.objects) {
+            int x = (int)std::floor(obj->position.x / chunkSize);
+            int y = (int)std::floor(obj->position.y / chunkSize);
+            buckets[{ x, y }]["objects"].push_back(SceneLoader::serializeObject(*obj));
+        }
+
+        fs::path manifestPath(manifestFile);
+        fs::path chunkDir = manifestPath.parent_path() / (manifestPath.stem().string() + "_chunks");
+        std::error_code ec;
+        fs::create_directories(chunkDir, ec);
+
+        json manifest = scene.document;
+        manifest["objects"] = json::array();
+        manifest["world"] = { {"chunkSize", chunkSize}, {"chunks", json::array()} };
+
+        for (const auto& [coord, chunkJson] : buckets) {
+            fs::path chunkPath = chunkDir / (std::to_string(coord.first) + "_" + std::to_string(coord.second) + ".json");
+            std::ofstream file(chunkPath, std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "[ERROR] Could not write chunk file: " << chunkPath << std::endl;
+                return false;
+            }
+            file << chunkJson.dump(4);
+            manifest["world"]["chunks"].push_back({
+                {"x", coord.first},
+                {"y", coord.second},
+                {"file", chunkPath.generic_string()}
+            });
+        }
+
+        std::ofstream file(manifestPath, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[ERROR] Could not write world manifest: " << manifestPath << std::endl;
+            return false;
+        }
+        file << manifest.dump(4);
+        std::cout << "[INFO] Cooked " << scene.objects.size() << " objects into " << buckets.size()
+                  << " chunks: " << manifestPath << std::endl;
+        return true;
+    }
+
+}
@@ -1,110 +1,1089 @@
 #include "../headers/physics.h"  
+#include "../headers/ColliderMerge.h"
+#include "../headers/SpriteAtlas.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 namespace Chained {
 
-    PhysicsSystem::PhysicsSystem(const b2Vec2& gravity) {
-        world = new b2World(gravity);
+    namespace {
+        constexpr uint32_t SnapshotMagic = 0x50485953; // "PHYS"
+
+        struct SnapshotHeader {
+            uint32_t magic;
+            uint32_t bodyCount;
+            uint32_t contactCount;
+            uint32_t partitionCount;
+        };
+
+        // The awake flag rides in the top bit of the generation, which keeps
+        // a record at 32 bytes.
+        constexpr uint32_t RecordAwakeBit = 0x80000000u;
+
+        struct BodyRecord {
+            uint32_t index;
+            uint32_t generation; // | RecordAwakeBit
+            float x, y, angle;
+            float vx, vy, angularVelocity;
+        };
+        static_assert(sizeof(BodyRecord) == 32, "BodyRecord must stay 32 bytes");
+
+        struct ContactRecord {
+            uint64_t entityA, entityB;
+            int32_t childA, childB;
+            int32_t pointCount;
+            uint32_t ids[b2_maxManifoldPoints];
+            float normalImpulses[b2_maxManifoldPoints];
+            float tangentImpulses[b2_maxManifoldPoints];
+        };
+
+        bool contactKeyLess(const ContactRecord& l, const ContactRecord& r) {
+            if (l.entityA != r.entityA) return l.entityA < r.entityA;
+            if (l.entityB != r.entityB) return l.entityB < r.entityB;
+            if (l.childA != r.childA) return l.childA < r.childA;
+            return l.childB < r.childB;
+        }
+
+        ContactRecord contactKey(b2Contact* contact) {
+            ContactRecord key{};
+            key.entityA = contact->GetFixtureA()->GetBody()->GetUserData().pointer;
+            key.entityB = contact->GetFixtureB()->GetBody()->GetUserData().pointer;
+            key.childA = contact->GetChildIndexA();
+            key.childB = contact->GetChildIndexB();
+            return key;
+        }
+
+        double microsSince(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        Entity entityOf(const b2Fixture* fixture) {
+            return Entity::unpack(fixture->GetBody()->GetUserData().pointer);
+        }
+
+        bool passesFilter(const b2Fixture* fixture, const QueryFilter& filter) {
+            if (fixture->IsSensor() && !filter.includeSensors) return false;
+            const b2Filter& data = fixture->GetFilterData();
+            if ((data.categoryBits & filter.maskBits) == 0 || (data.maskBits & filter.categoryBits) == 0) return false;
+            return filter.ignore.isNull() || entityOf(fixture) != filter.ignore;
+        }
+
+        b2Vec2 toMeters(const glm::vec2& v) {
+            return b2Vec2(v.x / PhysicsSystem::PHYSICS_SCALE, v.y / PhysicsSystem::PHYSICS_SCALE);
+        }
+
+        glm::vec2 toPixels(const b2Vec2& v) {
+            return { v.x * PhysicsSystem::PHYSICS_SCALE, v.y * PhysicsSystem::PHYSICS_SCALE };
+        }
+
+        class ClosestRayCallback : public b2RayCastCallback {
+        public:
+            ClosestRayCallback(const QueryFilter& filter, QueryHit& hit) : filter(filter), hit(hit) {}
+
+            float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override {
+                if (!passesFilter(fixture, filter)) return -1.0f; // ignore and continue
+                if (fraction < hit.fraction) {
+                    hit = { entityOf(fixture), toPixels(point), { normal.x, normal.y }, fraction };
+                }
+                return fraction; // clip the ray to the closest hit so far
+            }
+
+        private:
+            const QueryFilter& filter;
+            QueryHit& hit;
+        };
+
+        class FixtureCollector : public b2QueryCallback {
+        public:
+            FixtureCollector(const QueryFilter& filter, std::vector<b2Fixture*>& out) : filter(filter), out(out) {}
+
+            bool ReportFixture(b2Fixture* fixture) override {
+                if (passesFilter(fixture, filter)) out.push_back(fixture);
+                return true;
+            }
+
+        private:
+            const QueryFilter& filter;
+            std::vector<b2Fixture*>& out;
+        };
+    }
+
+    PhysicsSystem::Partition::Partition(PartitionId id, const b2Vec2& gravity, const glm::vec2& min, const glm::vec2& max)
+        : id(id), world(gravity), min(min), max(max) {
+        world.SetContactListener(this);
+        contacts.reserve(CONTACT_EVENT_RESERVE);
+    }
+
+    ContactEvent PhysicsSystem::Partition::makeEvent(ContactEvent::Type type, b2Contact* contact) const {
+        const b2Fixture* fixtureA = contact->GetFixtureA();
+        const b2Fixture* fixtureB = contact->GetFixtureB();
+        ContactEvent event{ type, 0, id, entityOf(fixtureA), entityOf(fixtureB) };
+        if (fixtureA->IsSensor()) event.flags |= ContactEvent::SensorA;
+        if (fixtureB->IsSensor()) event.flags |= ContactEvent::SensorB;
+
+        // Sensors and separated contacts have no manifold points.
+        if (type != ContactEvent::Type::End && contact->GetManifold()->pointCount > 0) {
+            b2WorldManifold manifold;
+            contact->GetWorldManifold(&manifold);
+            event.point = toPixels(manifold.points[0]);
+            event.normal = { manifold.normal.x, manifold.normal.y };
+        }
+        return event;
+    }
+
+    void PhysicsSystem::Partition::BeginContact(b2Contact* contact) {
+        if (eventMask & contactEventBit(ContactEvent::Type::Begin)) {
+            contacts.push_back(makeEvent(ContactEvent::Type::Begin, contact));
+        }
+    }
+
+    void PhysicsSystem::Partition::EndContact(b2Contact* contact) {
+        if (eventMask & contactEventBit(ContactEvent::Type::End)) {
+            ContactEvent event = makeEvent(ContactEvent::Type::End, contact);
+            const bool moving = !migrating.isNull() && (event.a == migrating || event.b == migrating);
+            (moving ? held : contacts).push_back(event);
+        }
+    }
+
+    void PhysicsSystem::Partition::PreSolve(b2Contact* contact, const b2Manifold* oldManifold) {
+        (void)oldManifold;
+        if (!(eventMask & contactEventBit(ContactEvent::Type::PreSolve))) return;
+        ContactEvent event = makeEvent(ContactEvent::Type::PreSolve, contact);
+        if (contact->GetManifold()->pointCount > 0) {
+            b2Vec2 point(event.point.x / PHYSICS_SCALE, event.point.y / PHYSICS_SCALE);
+            b2Vec2 va = contact->GetFixtureA()->GetBody()->GetLinearVelocityFromWorldPoint(point);
+            b2Vec2 vb = contact->GetFixtureB()->GetBody()->GetLinearVelocityFromWorldPoint(point);
+            // Positive while b moves into a along the normal.
+            event.approachSpeed = -b2Dot(vb - va, b2Vec2(event.normal.x, event.normal.y)) * PHYSICS_SCALE;
+        }
+        contacts.push_back(event);
+    }
+
+    void PhysicsSystem::Partition::PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) {
+        if (!(eventMask & contactEventBit(ContactEvent::Type::PostSolve))) return;
+        ContactEvent event = makeEvent(ContactEvent::Type::PostSolve, contact);
+        for (int32 i = 0; i < impulse->count; ++i) {
+            event.normalImpulse += impulse->normalImpulses[i];
+            event.tangentImpulse += impulse->tangentImpulses[i];
+        }
+        contacts.push_back(event);
+    }
+
+    PhysicsSystem::PhysicsSystem(Registry& registry, const b2Vec2& gravity)
+        : registry(registry), gravity(gravity) {
+        partitions.push_back(std::make_unique<Partition>(0, gravity, glm::vec2(0.0f), glm::vec2(0.0f)));
+        partitions[0]->eventMask = contactEventMask;
+        contactEvents.reserve(CONTACT_EVENT_RESERVE);
     }
 
     PhysicsSystem::~PhysicsSystem() {
         clear();
-        delete world;
     }
 
-    void PhysicsSystem::addObjects(std::vector<std::unique_ptr<SceneObject>>& objects) {
-        for (auto& obj : objects) {
-            if (!obj->physics.enabled) continue;
+    void PhysicsSystem::addObjects() {
+        for (Entity e : registry.colliders.entities()) {
+            addEntity(e);
+        }
+    }
 
-            b2BodyDef bodyDef;
+    void PhysicsSystem::addEntity(Entity e) {
+        const Collider* collider = registry.colliders.get(e);
+        const Transform* transform = registry.transforms.get(e);
+        if (!collider || !transform || !collider->desc.enabled) return;
+        if (registry.bodies.has(e)) return;
+        waitForStep();
 
-            // Robust enum mapping for body type
-            b2BodyType box2dType;
-            switch (obj->physics.bodyType) {
-            case BodyType::Dynamic:
-                box2dType = b2_dynamicBody;
-                break;
-            case BodyType::Kinematic:
-                box2dType = b2_kinematicBody;
-                break;
-            case BodyType::Static:
-            default:
-                box2dType = b2_staticBody;
-                break;
-            }
-            bodyDef.type = box2dType;
-            // *** Convert position from pixels to meters ***
-            bodyDef.position.Set(obj->position.x / PHYSICS_SCALE, obj->position.y / PHYSICS_SCALE);
+        const PhysicsBody& physics = collider->desc;
+        const std::string& name = registry.nameOf(e);
 
-            bodyDef.angle = obj->rotation;
-            bodyDef.fixedRotation = obj->physics.fixedRotation;
-            bodyDef.linearDamping = obj->physics.linearDamping;
-            bodyDef.angularDamping = obj->physics.angularDamping;
+        b2BodyDef bodyDef;
 
-            b2Body* body = world->CreateBody(&bodyDef);
+        // Robust enum mapping for body type
+        b2BodyType box2dType;
+        switch (physics.bodyType) {
+        case BodyType::Dynamic:
+            box2dType = b2_dynamicBody;
+            break;
+        case BodyType::Kinematic:
+            box2dType = b2_kinematicBody;
+            break;
+        case BodyType::Static:
+        default:
+            box2dType = b2_staticBody;
+            break;
+        }
+        bodyDef.type = box2dType;
+        // *** Convert position from pixels to meters ***
+        bodyDef.position.Set(transform->position.x / PHYSICS_SCALE, transform->position.y / PHYSICS_SCALE);
+
+        bodyDef.angle = transform->rotation;
+        bodyDef.fixedRotation = physics.fixedRotation;
+        bodyDef.linearDamping = physics.linearDamping;
+        bodyDef.angularDamping = physics.angularDamping;
+        bodyDef.userData.pointer = static_cast<uintptr_t>(e.pack());
+
+        b2Body* body = getWorld(partitionAt(transform->position))->CreateBody(&bodyDef);
+
+        b2Filter filter;
+        filter.categoryBits = physics.categoryBits;
+        filter.maskBits = physics.maskBits;
+        filter.groupIndex = physics.groupIndex;
+
+        // Polygons reuse the pieces the atlas traced for the entity's slice.
+        const SliceShape* sliceShape = nullptr;
+        if (physics.shapeType == ShapeType::Polygon) {
+            const Sprite* sprite = registry.sprites.get(e);
+            const SpriteAtlas* atlas = registry.getAtlas();
+            if (sprite && atlas && sprite->slice != InvalidSlice && !atlas->getSliceShape(sprite->slice).pieces.empty()) {
+                sliceShape = &atlas->getSliceShape(sprite->slice);
+            }
+            else {
+                std::cerr << "[ERROR] No sprite shape for polygon collider '" << name << "', using a box" << std::endl;
+            }
+        }
 
-            if (obj->physics.shapeType == ShapeType::Box) {
+        if (physics.shapeType == ShapeType::Box || (physics.shapeType == ShapeType::Polygon && !sliceShape)) {
+            b2PolygonShape shape;
+            // *** Convert size from pixels to meters ***
+            shape.SetAsBox((physics.size.x * 0.5f) / PHYSICS_SCALE, (physics.size.y * 0.5f) / PHYSICS_SCALE);
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = &shape;
+            fixtureDef.density = physics.material.density;
+            fixtureDef.friction = physics.material.friction;
+            fixtureDef.restitution = physics.material.bounciness;
+            fixtureDef.isSensor = physics.isSensor;
+            fixtureDef.filter = filter;
+            // Debug print
+            std::cout << "[DEBUG] Creating Box Fixture for: " << name << " | Density: " << fixtureDef.density << " | Size: (" << physics.size.x << ", " << physics.size.y << ")" << std::endl;
+            body->CreateFixture(&fixtureDef);
+        }
+        else if (physics.shapeType == ShapeType::Circle) {
+            b2CircleShape shape;
+            shape.m_p.Set(0, 0);
+            // *** Convert radius from pixels to meters ***
+            shape.m_radius = physics.radius / PHYSICS_SCALE;
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = &shape;
+            fixtureDef.density = physics.material.density;
+            fixtureDef.friction = physics.material.friction;
+            fixtureDef.restitution = physics.material.bounciness;
+            fixtureDef.isSensor = physics.isSensor;
+            fixtureDef.filter = filter;
+            // Debug print
+            std::cout << "[DEBUG] Creating Circle Fixture for: " << name << " | Density: " << fixtureDef.density << " | Radius: " << physics.radius << std::endl;
+            body->CreateFixture(&fixtureDef);
+        }
+        else if (sliceShape) {
+            static_assert(MaxPieceVertices == b2_maxPolygonVertices, "alpha shape pieces must fit a b2PolygonShape");
+            // Pieces are traced at slice size; stretch them to the collider size.
+            glm::vec2 toMeters = physics.size / (sliceShape->size * PHYSICS_SCALE);
+            b2FixtureDef fixtureDef;
+            fixtureDef.density = physics.material.density;
+            fixtureDef.friction = physics.material.friction;
+            fixtureDef.restitution = physics.material.bounciness;
+            fixtureDef.isSensor = physics.isSensor;
+            fixtureDef.filter = filter;
+            b2Vec2 vertices[b2_maxPolygonVertices];
+            for (const auto& piece : sliceShape->pieces) {
+                const int32 count = static_cast<int32>(piece.size());
+                for (int32 k = 0; k < count; ++k) {
+                    vertices[k].Set(piece[k].x * toMeters.x, piece[k].y * toMeters.y);
+                }
+                // Box2D welds vertices closer than its slop; skip pieces it would collapse.
+                bool degenerate = false;
+                for (int32 k = 0; k < count && !degenerate; ++k) {
+                    degenerate = (vertices[(k + 1) % count] - vertices[k]).LengthSquared() < b2_linearSlop * b2_linearSlop;
+                }
+                if (degenerate) continue;
                 b2PolygonShape shape;
-                // *** Convert size from pixels to meters ***
-                shape.SetAsBox((obj->physics.size.x * 0.5f) / PHYSICS_SCALE, (obj->physics.size.y * 0.5f) / PHYSICS_SCALE);
-                b2FixtureDef fixtureDef;
+                shape.Set(vertices, count);
                 fixtureDef.shape = &shape;
-                fixtureDef.density = obj->physics.material.density;
-                fixtureDef.friction = obj->physics.material.friction;
-                fixtureDef.restitution = obj->physics.material.bounciness;
-                fixtureDef.isSensor = obj->physics.isSensor;
-                // Debug print
-                std::cout << "[DEBUG] Creating Box Fixture for: " << obj->name << " | Density: " << fixtureDef.density << " | Size: (" << obj->physics.size.x << ", " << obj->physics.size.y << ")" << std::endl;
                 body->CreateFixture(&fixtureDef);
             }
-            else if (obj->physics.shapeType == ShapeType::Circle) {
-                b2CircleShape shape;
-                shape.m_p.Set(0, 0);
-                // *** Convert radius from pixels to meters ***
-                shape.m_radius = obj->physics.radius / PHYSICS_SCALE;
+        }
+        registry.bodies.add(e, { body });
+        if (box2dType != b2_staticBody) {
+            trackMoving(e, body);
+        }
+    }
+
+    void PhysicsSystem::trackMoving(Entity e, b2Body* body) {
+        if (movingSlot.size() <= e.index) movingSlot.resize(e.index + 1, NoSlot);
+        movingSlot[e.index] = static_cast<uint32_t>(moving.size());
+        moving.push_back({ body, e });
+    }
+
+    void PhysicsSystem::untrackMoving(Entity e) {
+        if (e.index >= movingSlot.size() || movingSlot[e.index] == NoSlot) return;
+        uint32_t slot = movingSlot[e.index];
+        movingSlot[e.index] = NoSlot;
+        if (slot + 1 != moving.size()) {
+            moving[slot] = moving.back();
+            movingSlot[moving[slot].entity.index] = slot;
+        }
+        moving.pop_back();
+    }
+
+    void PhysicsSystem::removeEntity(Entity e) {
+        PhysicsHandle* handle = registry.bodies.get(e);
+        if (!handle) return;
+        waitForStep();
+        untrackMoving(e);
+        handle->body->GetWorld()->DestroyBody(handle->body);
+        registry.bodies.remove(e);
+    }
+
+    void PhysicsSystem::setBodyEnabled(Entity e, bool enabled) {
+        PhysicsHandle* handle = registry.bodies.get(e);
+        if (!handle || handle->body->IsEnabled() == enabled) return;
+        waitForStep();
+        handle->body->SetEnabled(enabled);
+        if (handle->body->GetType() == b2_staticBody) return;
+        if (enabled) trackMoving(e, handle->body);
+        else untrackMoving(e);
+    }
+
+    size_t PhysicsSystem::mergeStaticColliders() {
+        waitForStep();
+
+        // Boxes can only share a body when their fixtures would be identical
+        // and they live in the same partition's world.
+        using MaterialKey = std::tuple<uint16_t, uint16_t, int16_t, float, float, PartitionId>;
+        struct Group {
+            std::vector<MergeRect> rects;
+            std::vector<Entity> entities;
+        };
+        std::map<MaterialKey, Group> groups;
+        for (size_t i = 0; i < registry.bodies.size(); ++i) {
+            Entity e = registry.bodies.owner(i);
+            const b2Body* body = registry.bodies.data()[i].body;
+            const Collider* collider = registry.colliders.get(e);
+            const Transform* transform = registry.transforms.get(e);
+            if (!collider || !transform || body->GetType() != b2_staticBody) continue;
+            const PhysicsBody& desc = collider->desc;
+            if (desc.shapeType != ShapeType::Box || desc.isSensor || transform->rotation != 0.0f) continue;
+
+            Group& group = groups[MaterialKey(desc.categoryBits, desc.maskBits, desc.groupIndex,
+                                              desc.material.friction, desc.material.bounciness, partitionOf(e))];
+            glm::vec2 half = 0.5f * desc.size;
+            group.rects.push_back({ transform->position - half, transform->position + half });
+            group.entities.push_back(e);
+        }
+
+        size_t mergedBoxes = 0, createdBodies = 0, edgeCount = 0;
+        std::vector<b2Vec2> vertices;
+        for (const auto& [key, group] : groups) {
+            for (const MergedRegion& region : mergeRects(group.rects)) {
+                size_t edges = 0;
+                for (const auto& loop : region.loops) edges += loop.size();
+                if (edges >= region.rects.size()) continue; // no fewer proxies than the boxes
+
+                for (uint32_t r : region.rects) {
+                    removeEntity(group.entities[r]);
+                }
+
+                Entity owner = registry.create();
+                b2BodyDef bodyDef;
+                bodyDef.type = b2_staticBody;
+                bodyDef.userData.pointer = static_cast<uintptr_t>(owner.pack());
+                b2Body* body = getWorld(std::get<5>(key))->CreateBody(&bodyDef);
+
                 b2FixtureDef fixtureDef;
-                fixtureDef.shape = &shape;
-                fixtureDef.density = obj->physics.material.density;
-                fixtureDef.friction = obj->physics.material.friction;
-                fixtureDef.restitution = obj->physics.material.bounciness;
-                fixtureDef.isSensor = obj->physics.isSensor;
-                // Debug print
-                std::cout << "[DEBUG] Creating Circle Fixture for: " << obj->name << " | Density: " << fixtureDef.density << " | Radius: " << obj->physics.radius << std::endl;
-                body->CreateFixture(&fixtureDef);
+                fixtureDef.friction = std::get<3>(key);
+                fixtureDef.restitution = std::get<4>(key);
+                fixtureDef.filter.categoryBits = std::get<0>(key);
+                fixtureDef.filter.maskBits = std::get<1>(key);
+                fixtureDef.filter.groupIndex = std::get<2>(key);
+                for (const auto& loop : region.loops) {
+                    vertices.clear();
+                    for (const glm::vec2& p : loop) {
+                        vertices.emplace_back(p.x / PHYSICS_SCALE, p.y / PHYSICS_SCALE);
+                    }
+                    b2ChainShape chain;
+                    chain.CreateLoop(vertices.data(), static_cast<int32>(vertices.size()));
+                    fixtureDef.shape = &chain;
+                    body->CreateFixture(&fixtureDef);
+                    mergedOutlines.push_back(loop);
+                }
+                registry.bodies.add(owner, { body });
+
+                mergedBoxes += region.rects.size();
+                edgeCount += edges;
+                ++createdBodies;
             }
-            bodyMap[obj.get()] = body;
         }
+
+        if (mergedBoxes > 0) {
+            std::cout << "[INFO] Merged " << mergedBoxes << " static boxes into " << createdBodies
+                      << " bodies with " << edgeCount << " edges" << std::endl;
+        }
+        return mergedBoxes;
+    }
+
+    void PhysicsSystem::setStaticBoxes(Entity owner, const MergeRect* rects, size_t count, const PhysicsBody& desc,
+                                       PartitionId partition) {
+        removeEntity(owner);
+        if (count == 0 || partition >= partitions.size()) return;
+        waitForStep();
+
+        b2BodyDef bodyDef;
+        bodyDef.type = b2_staticBody;
+        bodyDef.userData.pointer = static_cast<uintptr_t>(owner.pack());
+        b2Body* body = getWorld(partition)->CreateBody(&bodyDef);
+
+        b2FixtureDef fixtureDef;
+        fixtureDef.friction = desc.material.friction;
+        fixtureDef.restitution = desc.material.bounciness;
+        fixtureDef.isSensor = desc.isSensor;
+        fixtureDef.filter.categoryBits = desc.categoryBits;
+        fixtureDef.filter.maskBits = desc.maskBits;
+        fixtureDef.filter.groupIndex = desc.groupIndex;
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec2 half = 0.5f * (rects[i].max - rects[i].min) / PHYSICS_SCALE;
+            glm::vec2 center = 0.5f * (rects[i].min + rects[i].max) / PHYSICS_SCALE;
+            b2PolygonShape box;
+            box.SetAsBox(half.x, half.y, b2Vec2(center.x, center.y), 0.0f);
+            fixtureDef.shape = &box;
+            body->CreateFixture(&fixtureDef);
+        }
+        registry.bodies.add(owner, { body });
     }
 
     void PhysicsSystem::step(float dt) {
+        applyCommands();
+        for (auto& partition : partitions) {
+            stepPartition(*partition, dt);
+        }
+    }
+
+    void PhysicsSystem::stepPartition(Partition& partition, float dt) {
         const int32 velocityIterations = 6;
         const int32 positionIterations = 2;
-        world->Step(dt, velocityIterations, positionIterations);
+        partition.world.Step(dt, velocityIterations, positionIterations);
+    }
+
+    void PhysicsSystem::syncToRegistry(JobSystem* jobs) {
+        waitForStep();
+        posesPending = false; // recaptured below
+        poses.resize(moving.size());
+        awake.resize(moving.size());
+        // Each slot writes only its own entries, so ranges can run in parallel.
+        auto captureRange = [this](size_t first, size_t last) { capturePoses(first, last); };
+        if (jobs && moving.size() >= SYNC_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(moving.size(), SYNC_GRAIN, captureRange));
+        }
+        else {
+            captureRange(0, moving.size());
+        }
+        publishPoses();
+    }
+
+    void PhysicsSystem::beginStep(float dt, JobSystem* jobs) {
+        waitForStep();
+        applyCommands();
+
+        // Bodies cannot be added or removed until finishStep, so the buffers
+        // are sized here and every capture range writes only its own slots.
+        poses.resize(moving.size());
+        awake.resize(moving.size());
+        posesPending = true;
+
+        if (!jobs) {
+            step(dt);
+            capturePoses(0, moving.size());
+            return;
+        }
+
+        // Partitions share no Box2D state, so each steps as its own job and
+        // capture starts once all of them are done.
+        stepJobs = jobs;
+        std::vector<JobHandle> stepped;
+        stepped.reserve(partitions.size());
+        for (auto& partition : partitions) {
+            Partition* target = partition.get();
+            stepped.push_back(jobs->schedule([this, target, dt]() { stepPartition(*target, dt); }));
+        }
+        pendingStep = jobs->parallelFor(moving.size(), SYNC_GRAIN,
+            [this](size_t first, size_t last) { capturePoses(first, last); }, stepped);
+    }
+
+    void PhysicsSystem::finishStep() {
+        waitForStep();
+        if (!posesPending) return;
+        posesPending = false;
+        publishPoses();
+    }
+
+    void PhysicsSystem::queueLinearVelocity(Entity e, const b2Vec2& velocity) {
+        commands.push_back({ BodyCommand::Type::SetLinearVelocity, e, velocity });
+    }
+
+    void PhysicsSystem::queueForce(Entity e, const b2Vec2& force) {
+        commands.push_back({ BodyCommand::Type::ApplyForce, e, force });
     }
 
-    void PhysicsSystem::syncToObjects(std::vector<std::unique_ptr<SceneObject>>& objects) {
-        for (auto& obj : objects) {
-            if (!obj->physics.enabled) continue;
-            b2Body* body = bodyMap[obj.get()];
+    void PhysicsSystem::queueImpulse(Entity e, const b2Vec2& impulse) {
+        commands.push_back({ BodyCommand::Type::ApplyImpulse, e, impulse });
+    }
+
+    void PhysicsSystem::applyCommands() {
+        for (const BodyCommand& cmd : commands) {
+            b2Body* body = getBodyFor(cmd.entity);
             if (!body) continue;
+            switch (cmd.type) {
+            case BodyCommand::Type::SetLinearVelocity:
+                body->SetLinearVelocity(cmd.value);
+                break;
+            case BodyCommand::Type::ApplyForce:
+                body->ApplyForceToCenter(cmd.value, true);
+                break;
+            case BodyCommand::Type::ApplyImpulse:
+                body->ApplyLinearImpulseToCenter(cmd.value, true);
+                break;
+            }
+        }
+        commands.clear();
+    }
+
+    void PhysicsSystem::capturePoses(size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            MovingBody& entry = moving[i];
+            const b2Body* body = entry.body;
+            // Sleeping bodies keep their published Transform, except on the
+            // step they fell asleep (its integration moved them one last
+            // time) and after a teleport.
+            const bool isAwake = body->IsAwake();
+            awake[i] = (isAwake || entry.wasAwake || entry.dirty) ? 1 : 0;
+            entry.wasAwake = isAwake;
+            entry.dirty = false;
+            if (!awake[i]) continue;
             b2Vec2 pos = body->GetPosition();
             // *** Convert position from meters to pixels ***
-            obj->position.x = pos.x * PHYSICS_SCALE;
-            obj->position.y = pos.y * PHYSICS_SCALE;
-            obj->rotation = body->GetAngle();
+            poses[i] = { entry.entity, { pos.x * PHYSICS_SCALE, pos.y * PHYSICS_SCALE }, body->GetAngle() };
+        }
+    }
+
+    void PhysicsSystem::mergeContacts() {
+        contactEvents.clear();
+        for (auto& partition : partitions) {
+            contactEvents.insert(contactEvents.end(), partition->contacts.begin(), partition->contacts.end());
+            partition->contacts.clear();
+        }
+        if (!migratedEnds.empty()) pairMigratedContacts();
+    }
+
+    void PhysicsSystem::pairMigratedContacts() {
+        // A migrated body touches again on its first step in the new world
+        // whatever it still overlaps there. Each such Begin cancels one held
+        // End of the same entity pair; the Ends left over really separated.
+        auto samePair = [](const ContactEvent& x, const ContactEvent& y) {
+            return (x.a == y.a && x.b == y.b) || (x.a == y.b && x.b == y.a);
+        };
+        size_t kept = 0;
+        for (size_t i = 0; i < contactEvents.size(); ++i) {
+            const ContactEvent& event = contactEvents[i];
+            if (event.type == ContactEvent::Type::Begin) {
+                auto end = std::find_if(migratedEnds.begin(), migratedEnds.end(),
+                    [&](const ContactEvent& held) { return samePair(held, event); });
+                if (end != migratedEnds.end()) {
+                    *end = migratedEnds.back();
+                    migratedEnds.pop_back();
+                    continue;
+                }
+            }
+            contactEvents[kept++] = event;
+        }
+        contactEvents.resize(kept);
+        contactEvents.insert(contactEvents.end(), migratedEnds.begin(), migratedEnds.end());
+        migratedEnds.clear();
+    }
+
+    void PhysicsSystem::publishPoses() {
+        mergeContacts();
+        movedEntities.clear();
+        // Poses carry their entity, so bodies removed since the capture just
+        // fail to resolve instead of landing on the wrong Transform.
+        for (size_t i = 0; i < poses.size(); ++i) {
+            if (!awake[i]) continue;
+            const BodyPose& pose = poses[i];
+            Transform* transform = registry.transforms.get(pose.entity);
+            if (!transform) continue;
+            transform->position = pose.position;
+            transform->rotation = pose.rotation;
+            movedEntities.push_back(pose.entity);
+        }
+    }
+
+    void PhysicsSystem::waitForStep() {
+        if (pendingStep) {
+            stepJobs->wait(pendingStep);
+            pendingStep.reset();
         }
     }
 
     void PhysicsSystem::clear() {
-        for (auto it = bodyMap.begin(); it != bodyMap.end(); ++it) {
-            world->DestroyBody(it->second);
+        waitForStep();
+        posesPending = false;
+        moving.clear();
+        movingSlot.clear();
+        poses.clear();
+        awake.clear();
+        movedEntities.clear();
+        for (const PhysicsHandle& handle : registry.bodies) {
+            handle.body->GetWorld()->DestroyBody(handle.body);
+        }
+        registry.bodies.clear();
+        mergedOutlines.clear();
+        partitions.resize(1);
+        partitions[0]->contacts.clear();
+        partitions[0]->held.clear();
+        contactEvents.clear();
+        migratedEnds.clear();
+    }
+
+    void PhysicsSystem::setContactEventMask(uint8_t mask) {
+        waitForStep(); // the listeners read it mid-step
+        contactEventMask = mask;
+        for (auto& partition : partitions) {
+            partition->eventMask = mask;
+        }
+    }
+
+    PartitionId PhysicsSystem::addPartition(const glm::vec2& min, const glm::vec2& max) {
+        waitForStep();
+        PartitionId id = static_cast<PartitionId>(partitions.size());
+        partitions.push_back(std::make_unique<Partition>(id, gravity, min, max));
+        partitions.back()->eventMask = contactEventMask;
+
+        // Adopt what partition 0 already holds in the new region.
+        b2World* catchAll = getWorld(0);
+        std::vector<Entity> adopted;
+        for (size_t i = 0; i < registry.bodies.size(); ++i) {
+            if (registry.bodies.data()[i].body->GetWorld() != catchAll) continue;
+            Entity e = registry.bodies.owner(i);
+            const Transform* transform = registry.transforms.get(e);
+            if (transform && partitionAt(transform->position) == id) adopted.push_back(e);
+        }
+        for (Entity e : adopted) {
+            moveToPartition(e, id);
+        }
+        std::cout << "[INFO] Physics partition " << id << " created with " << adopted.size() << " bodies" << std::endl;
+        return id;
+    }
+
+    PartitionId PhysicsSystem::partitionAt(const glm::vec2& position) const {
+        for (size_t i = 1; i < partitions.size(); ++i) {
+            const Partition& p = *partitions[i];
+            if (position.x >= p.min.x && position.x < p.max.x && position.y >= p.min.y && position.y < p.max.y) {
+                return static_cast<PartitionId>(i);
+            }
+        }
+        return 0;
+    }
+
+    void PhysicsSystem::partitionsOverlapping(const glm::vec2& min, const glm::vec2& max, std::vector<PartitionId>& out) const {
+        bool contained = false;
+        for (size_t i = 1; i < partitions.size(); ++i) {
+            const Partition& p = *partitions[i];
+            if (max.x <= p.min.x || min.x >= p.max.x || max.y <= p.min.y || min.y >= p.max.y) continue;
+            out.push_back(static_cast<PartitionId>(i));
+            contained |= min.x >= p.min.x && max.x <= p.max.x && min.y >= p.min.y && max.y <= p.max.y;
         }
-        bodyMap.clear();
+        if (!contained) out.push_back(0);
+    }
+
+    PartitionId PhysicsSystem::partitionOf(Entity e) const {
+        const PhysicsHandle* handle = registry.bodies.get(e);
+        if (handle) {
+            const b2World* world = handle->body->GetWorld();
+            for (size_t i = 0; i < partitions.size(); ++i) {
+                if (&partitions[i]->world == world) return static_cast<PartitionId>(i);
+            }
+        }
+        return 0;
+    }
+
+    bool PhysicsSystem::moveToPartition(Entity e, PartitionId target) {
+        PhysicsHandle* handle = registry.bodies.get(e);
+        if (!handle || target >= partitions.size()) return false;
+        b2Body* old = handle->body;
+        b2World* world = getWorld(target);
+        if (old->GetWorld() == world) return true;
+        waitForStep();
+
+        // Box2D cannot move a body between worlds, so rebuild it field by field.
+        b2BodyDef def;
+        def.type = old->GetType();
+        def.position = old->GetPosition();
+        def.angle = old->GetAngle();
+        def.linearVelocity = old->GetLinearVelocity();
+        def.angularVelocity = old->GetAngularVelocity();
+        def.linearDamping = old->GetLinearDamping();
+        def.angularDamping = old->GetAngularDamping();
+        def.allowSleep = old->IsSleepingAllowed();
+        def.awake = old->IsAwake();
+        def.fixedRotation = old->IsFixedRotation();
+        def.bullet = old->IsBullet();
+        def.enabled = old->IsEnabled();
+        def.gravityScale = old->GetGravityScale();
+        def.userData = old->GetUserData();
+        b2Body* body = world->CreateBody(&def);
+
+        // CreateFixture prepends, so copy back to front to keep the order.
+        std::vector<b2Fixture*> fixtures;
+        for (b2Fixture* f = old->GetFixtureList(); f; f = f->GetNext()) fixtures.push_back(f);
+        for (auto it = fixtures.rbegin(); it != fixtures.rend(); ++it) {
+            b2Fixture* f = *it;
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = f->GetShape();
+            fixtureDef.density = f->GetDensity();
+            fixtureDef.friction = f->GetFriction();
+            fixtureDef.restitution = f->GetRestitution();
+            fixtureDef.restitutionThreshold = f->GetRestitutionThreshold();
+            fixtureDef.isSensor = f->IsSensor();
+            fixtureDef.filter = f->GetFilterData();
+            fixtureDef.userData = f->GetUserData();
+            body->CreateFixture(&fixtureDef);
+        }
+
+        // Destroying the old body ends its contacts; hold those Ends so the
+        // next merge can cancel them against the new world's Begins.
+        Partition& from = *partitions[partitionOf(e)];
+        from.migrating = e;
+        old->GetWorld()->DestroyBody(old);
+        from.migrating = NullEntity;
+        migratedEnds.insert(migratedEnds.end(), from.held.begin(), from.held.end());
+        from.held.clear();
+        handle->body = body;
+        if (e.index < movingSlot.size() && movingSlot[e.index] != NoSlot) {
+            moving[movingSlot[e.index]].body = body;
+        }
+        return true;
+    }
+
+    void PhysicsSystem::migrateMovedBodies() {
+        if (partitions.size() < 2) return;
+        for (Entity e : movedEntities) {
+            const Transform* transform = registry.transforms.get(e);
+            if (!transform) continue;
+            PartitionId target = partitionAt(transform->position);
+            if (target != partitionOf(e)) {
+                moveToPartition(e, target);
+            }
+        }
+    }
+
+    ContactStats PhysicsSystem::getContactStats() {
+        waitForStep();
+        ContactStats stats;
+        for (auto& partition : partitions) {
+            for (b2Contact* contact = partition->world.GetContactList(); contact; contact = contact->GetNext()) {
+                ++stats.pairs;
+                if (contact->IsTouching()) ++stats.touching;
+            }
+        }
+        return stats;
+    }
+
+    void PhysicsSystem::saveSnapshot(PhysicsSnapshot& out) {
+        auto start = std::chrono::steady_clock::now();
+        waitForStep();
+
+        size_t contactCount = 0;
+        for (auto& partition : partitions) {
+            contactCount += partition->world.GetContactCount();
+        }
+
+        // Sized for every contact up front; untouched ones are trimmed below.
+        out.bytes.resize(sizeof(SnapshotHeader) + moving.size() * sizeof(BodyRecord) + contactCount * sizeof(ContactRecord));
+        uint8_t* cursor = out.bytes.data() + sizeof(SnapshotHeader);
+
+        for (const MovingBody& entry : moving) {
+            const b2Body* body = entry.body;
+            BodyRecord record;
+            record.index = entry.entity.index;
+            record.generation = entry.entity.generation & ~RecordAwakeBit;
+            record.x = body->GetPosition().x;
+            record.y = body->GetPosition().y;
+            record.angle = body->GetAngle();
+            record.vx = body->GetLinearVelocity().x;
+            record.vy = body->GetLinearVelocity().y;
+            record.angularVelocity = body->GetAngularVelocity();
+            if (body->IsAwake()) record.generation |= RecordAwakeBit;
+            std::memcpy(cursor, &record, sizeof(record));
+            cursor += sizeof(record);
+        }
+
+        uint32_t touching = 0;
+        for (auto& partition : partitions) {
+            for (b2Contact* contact = partition->world.GetContactList(); contact; contact = contact->GetNext()) {
+                if (!contact->IsTouching()) continue;
+                ContactRecord record = contactKey(contact);
+                const b2Manifold* manifold = contact->GetManifold();
+                record.pointCount = manifold->pointCount;
+                for (int32 i = 0; i < manifold->pointCount; ++i) {
+                    record.ids[i] = manifold->points[i].id.key;
+                    record.normalImpulses[i] = manifold->points[i].normalImpulse;
+                    record.tangentImpulses[i] = manifold->points[i].tangentImpulse;
+                }
+                std::memcpy(cursor, &record, sizeof(record));
+                cursor += sizeof(record);
+                ++touching;
+            }
+        }
+        out.bytes.resize(cursor - out.bytes.data());
+
+        SnapshotHeader header{ SnapshotMagic, static_cast<uint32_t>(moving.size()), touching, static_cast<uint32_t>(partitions.size()) };
+        std::memcpy(out.bytes.data(), &header, sizeof(header));
+        lastSaveMicros = microsSince(start);
+    }
+
+    bool PhysicsSystem::restoreSnapshot(const PhysicsSnapshot& snapshot) {
+        auto start = std::chrono::steady_clock::now();
+        SnapshotHeader header;
+        if (snapshot.size() < sizeof(header)) return false;
+        std::memcpy(&header, snapshot.bytes.data(), sizeof(header));
+        if (header.magic != SnapshotMagic ||
+            snapshot.size() != sizeof(header) + header.bodyCount * sizeof(BodyRecord) + header.contactCount * sizeof(ContactRecord)) {
+            std::cerr << "[ERROR] Physics snapshot is malformed" << std::endl;
+            return false;
+        }
+
+        waitForStep();
+        posesPending = false; // the restored state replaces the step in flight
+        commands.clear();
+        movedEntities.clear();
+
+        const uint8_t* cursor = snapshot.bytes.data() + sizeof(header);
+        size_t missing = 0;
+        for (uint32_t i = 0; i < header.bodyCount; ++i, cursor += sizeof(BodyRecord)) {
+            BodyRecord record;
+            std::memcpy(&record, cursor, sizeof(record));
+            Entity e{ record.index, record.generation & ~RecordAwakeBit };
+            b2Body* body = getBodyFor(e);
+            if (!body) {
+                ++missing;
+                continue;
+            }
+            // SetAwake(false) zeroes velocity, so sleep is applied last.
+            body->SetAwake(true);
+            body->SetTransform(b2Vec2(record.x, record.y), record.angle);
+            body->SetLinearVelocity(b2Vec2(record.vx, record.vy));
+            body->SetAngularVelocity(record.angularVelocity);
+            if (!(record.generation & RecordAwakeBit)) body->SetAwake(false);
+            markDirty(e);
+
+            if (Transform* transform = registry.transforms.get(e)) {
+                transform->position = { record.x * PHYSICS_SCALE, record.y * PHYSICS_SCALE };
+                transform->rotation = record.angle;
+                movedEntities.push_back(e);
+            }
+        }
+
+        // Records were written in world contact order; sort a copy by pair so
+        // the live contacts can look theirs up.
+        std::vector<ContactRecord> contacts(header.contactCount);
+        if (header.contactCount > 0) {
+            std::memcpy(contacts.data(), cursor, header.contactCount * sizeof(ContactRecord));
+        }
+        std::sort(contacts.begin(), contacts.end(), contactKeyLess);
+        for (auto& partition : partitions) {
+            for (b2Contact* contact = partition->world.GetContactList(); contact; contact = contact->GetNext()) {
+                ContactRecord key = contactKey(contact);
+                auto it = std::lower_bound(contacts.begin(), contacts.end(), key, contactKeyLess);
+                if (it == contacts.end() || contactKeyLess(key, *it)) continue;
+
+                // Box2D carries impulses across steps by feature id, so match on it.
+                b2Manifold* manifold = contact->GetManifold();
+                for (int32 i = 0; i < manifold->pointCount; ++i) {
+                    manifold->points[i].normalImpulse = 0.0f;
+                    manifold->points[i].tangentImpulse = 0.0f;
+                    for (int32 j = 0; j < it->pointCount; ++j) {
+                        if (manifold->points[i].id.key == it->ids[j]) {
+                            manifold->points[i].normalImpulse = it->normalImpulses[j];
+                            manifold->points[i].tangentImpulse = it->tangentImpulses[j];
+                        }
+                    }
+                }
+            }
+        }
+
+        lastRestoreMicros = microsSince(start);
+        if (missing > 0) {
+            std::cerr << "[ERROR] Physics snapshot referenced " << missing << " bodies that no longer exist" << std::endl;
+        }
+        return missing == 0;
+    }
+
+    template <typename Fn>
+    void PhysicsSystem::runQueries(size_t count, JobSystem* jobs, Fn&& fn) {
+        waitForStep();
+        if (jobs && count >= QUERY_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(count, QUERY_GRAIN, [&fn](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) fn(i);
+            }));
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) fn(i);
+        }
+    }
+
+    void PhysicsSystem::raycast(const RayQuery* queries, size_t count, QueryHit* hits, JobSystem* jobs) {
+        runQueries(count, jobs, [this, queries, hits](size_t i) { hits[i] = raycastOne(queries[i]); });
+    }
+
+    void PhysicsSystem::shapeCast(const ShapeCastQuery* queries, size_t count, QueryHit* hits, JobSystem* jobs) {
+        runQueries(count, jobs, [this, queries, hits](size_t i) { hits[i] = shapeCastOne(queries[i]); });
+    }
+
+    void PhysicsSystem::overlap(const AabbQuery* queries, size_t count, OverlapResults& out, JobSystem* jobs) {
+        out.entities.clear();
+        out.first.assign(count, 0);
+        out.count.assign(count, 0);
+
+        // Each range gathers locally and appends its block once, so queries
+        // stay contiguous even when ranges finish out of order.
+        std::mutex appendMutex;
+        auto overlapRange = [&](size_t begin, size_t end) {
+            thread_local std::vector<Entity> local;
+            thread_local std::vector<uint32_t> localCount;
+            local.clear();
+            localCount.assign(end - begin, 0);
+            for (size_t i = begin; i < end; ++i) {
+                size_t before = local.size();
+                overlapOne(queries[i], local);
+                localCount[i - begin] = static_cast<uint32_t>(local.size() - before);
+            }
+            std::lock_guard<std::mutex> lock(appendMutex);
+            uint32_t base = static_cast<uint32_t>(out.entities.size());
+            out.entities.insert(out.entities.end(), local.begin(), local.end());
+            for (size_t i = begin; i < end; ++i) {
+                out.first[i] = base;
+                out.count[i] = localCount[i - begin];
+                base += localCount[i - begin];
+            }
+        };
+
+        waitForStep();
+        if (jobs && count >= QUERY_GRAIN * 2) {
+            jobs->wait(jobs->parallelFor(count, QUERY_GRAIN, overlapRange));
+        }
+        else {
+            overlapRange(0, count);
+        }
+    }
+
+    QueryHit PhysicsSystem::raycastOne(const RayQuery& query) const {
+        QueryHit hit;
+        b2Vec2 from = toMeters(query.from);
+        b2Vec2 to = toMeters(query.to);
+        if ((to - from).LengthSquared() <= 0.0f) return hit; // Box2D asserts on empty rays
+
+        // Every partition sees the same segment, so fractions compare directly.
+        ClosestRayCallback callback(query.filter, hit);
+        for (const auto& partition : partitions) {
+            partition->world.RayCast(&callback, from, to);
+        }
+        return hit;
+    }
+
+    QueryHit PhysicsSystem::shapeCastOne(const ShapeCastQuery& query) const {
+        QueryHit hit;
+        b2PolygonShape box;
+        b2CircleShape circle;
+        const b2Shape* cast = nullptr;
+        if (query.shape == ShapeType::Circle) {
+            circle.m_radius = query.radius / PHYSICS_SCALE;
+            cast = &circle;
+        }
+        else {
+            box.SetAsBox(0.5f * query.size.x / PHYSICS_SCALE, 0.5f * query.size.y / PHYSICS_SCALE);
+            cast = &box;
+        }
+
+        b2Transform start(toMeters(query.from), b2Rot(query.rotation));
+        b2Vec2 translation = toMeters(query.to) - start.p;
+        b2Transform end(start.p + translation, start.q);
+
+        // Broadphase candidates from the swept bounds, then exact casts.
+        b2AABB sweptBounds, endBounds;
+        cast->ComputeAABB(&sweptBounds, start, 0);
+        cast->ComputeAABB(&endBounds, end, 0);
+        sweptBounds.Combine(endBounds);
+
+        // Per thread and reused, so batched queries stop allocating once warm.
+        thread_local std::vector<b2Fixture*> candidates;
+        candidates.clear();
+        FixtureCollector collector(query.filter, candidates);
+        for (const auto& partition : partitions) {
+            partition->world.QueryAABB(&collector, sweptBounds);
+        }
+
+        b2ShapeCastInput input;
+        input.proxyB.Set(cast, 0);
+        input.transformB = start;
+        input.translationB = translation;
+        for (b2Fixture* fixture : candidates) {
+            const b2Shape* shape = fixture->GetShape();
+            input.transformA = fixture->GetBody()->GetTransform();
+            for (int32 child = 0; child < shape->GetChildCount(); ++child) {
+                input.proxyA.Set(shape, child);
+                b2ShapeCastOutput output;
+                if (b2ShapeCast(&output, &input) && output.lambda < hit.fraction) {
+                    hit = { entityOf(fixture), toPixels(output.point), { output.normal.x, output.normal.y }, output.lambda };
+                }
+            }
+        }
+        return hit;
+    }
+
+    void PhysicsSystem::overlapOne(const AabbQuery& query, std::vector<Entity>& out) const {
+        b2AABB bounds;
+        bounds.lowerBound = toMeters(query.min);
+        bounds.upperBound = toMeters(query.max);
+
+        thread_local std::vector<b2Fixture*> candidates; // as in shapeCastOne
+        candidates.clear();
+        FixtureCollector collector(query.filter, candidates);
+        for (const auto& partition : partitions) {
+            partition->world.QueryAABB(&collector, bounds);
+        }
+
+        // The broadphase reports fattened bounds; check the fixture's own.
+        size_t start = out.size();
+        for (b2Fixture* fixture : candidates) {
+            bool touching = false;
+            for (int32 child = 0; child < fixture->GetShape()->GetChildCount() && !touching; ++child) {
+                touching = b2TestOverlap(fixture->GetAABB(child), bounds);
+            }
+            if (!touching) continue;
+            Entity e = entityOf(fixture);
+            if (std::find(out.begin() + start, out.end(), e) == out.end()) out.push_back(e);
+        }
+    }
+
+    void PhysicsSystem::markDirty(Entity e) {
+        if (e.index < movingSlot.size() && movingSlot[e.index] != NoSlot) {
+            moving[movingSlot[e.index]].dirty = true;
+        }
+    }
+
+    void PhysicsSystem::setTransform(Entity e, const glm::vec2& position, float rotation) {
+        b2Body* body = getBodyFor(e);
+        if (!body) return;
+        waitForStep();
+        body->SetTransform(toMeters(position), rotation);
+        markDirty(e);
     }
 
-    b2Body* PhysicsSystem::getBodyFor(SceneObject* obj) {
-        auto it = bodyMap.find(obj);
-        return (it != bodyMap.end()) ? it->second : nullptr;
+    b2Body* PhysicsSystem::getBodyFor(Entity e) {
+        PhysicsHandle* handle = registry.bodies.get(e);
+        return handle ? handle->body : nullptr;
     }
 
 }
\ No newline at end of file
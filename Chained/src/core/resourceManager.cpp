@@ -134,22 +134,38 @@ namespace Chained {
 	Texture2D* ResourceManager::loadTextureFromFile(const GLchar* file, GLboolean alpha) {
 		std::cout << "[DEBUG] [loadTextureFromFile] Begin" << std::endl;
 
-		Texture2D* texture = new Texture2D();
+		DecodedImage image;
+		if (!decodeImage(file, image)) {
+			return nullptr;
+		}
+		return uploadImage(image, alpha);
+	}
 
-		int width = 0, height = 0, nrChannels = 0;
+	Texture2DPtr ResourceManager::createTexture(DecodedImage& image, GLboolean alpha, const std::string& name) {
+		m_textureMap[name] = std::shared_ptr<Texture2D>(uploadImage(image, alpha));
+		return m_textureMap[name];
+	}
 
+	bool ResourceManager::decodeImage(const std::string& file, DecodedImage& out) {
 		std::string filePath = solveResourcePath(file);
 		std::cout << "[DEBUG] Resolved texture path: " << filePath << std::endl;
 
-		unsigned char* image = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 4);
-		std::cout << "[DEBUG] Loaded image: " << width << "x" << height << " channels: " << nrChannels << std::endl;
-		if (!image) {
+		out.pixels = stbi_load(filePath.c_str(), &out.width, &out.height, &out.channels, 4);
+		if (!out.pixels) {
 			std::cerr << "[ERROR] Failed to load texture from file: " << file << std::endl;
-			delete texture;
+			return false;
+		}
+		std::cout << "[DEBUG] Loaded image: " << out.width << "x" << out.height << " channels: " << out.channels << std::endl;
+		return true;
+	}
+
+	Texture2D* ResourceManager::uploadImage(DecodedImage& image, GLboolean alpha) {
+		if (!image.pixels) {
 			return nullptr;
 		}
 
-		std::cout << "[DEBUG] Loaded image: " << width << "x" << height << " channels: " << nrChannels << std::endl;
+		Texture2D* texture = new Texture2D();
+		int nrChannels = image.channels;
 
 		// Set the correct format based on the number of channels
 // Warn if user asked for alpha but image doesn't have 4 channels
@@ -177,15 +193,17 @@ namespace Chained {
 		else {
 			std::cerr << "[ERROR] Unsupported channel count: " << nrChannels << "\n";
 			delete texture;
-			stbi_image_free(image);
+			stbi_image_free(image.pixels);
+			image.pixels = nullptr;
 			return nullptr;
 		}
 
 
-		texture->generate(width, height, image);
+		texture->generate(image.width, image.height, image.pixels);
 		std::cout << "[DEBUG] Finished texture->generate()" << std::endl;
-		std::cout << "[DEBUG] Freeing image at pointer: " << static_cast<void*>(image) << std::endl;
-		stbi_image_free(image);
+		std::cout << "[DEBUG] Freeing image at pointer: " << static_cast<void*>(image.pixels) << std::endl;
+		stbi_image_free(image.pixels);
+		image.pixels = nullptr;
 
 		return texture;
 	}
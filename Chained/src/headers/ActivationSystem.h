@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Registry.h"
+
+namespace Chained {
+
+    class Camera;
+    class PhysicsSystem;
+
+    // Simulation level of detail around the camera. Entities near the view
+    // center are Active and tick every frame; a ring further out is Reduced
+    // and ticks every few frames; everything beyond is Dormant: its
+    // dynamic bodies are disabled (out of the broadphase and the solver) and
+    // gameplay skips it. Leaving a tier takes `hysteresis` more distance than
+    // entering it, so entities on a border do not flip every frame.
+    //
+    // Dormant entities are bucketed in a coarse grid and only the cells
+    // around the camera are looked at, so per-frame cost follows what is
+    // near the camera rather than the size of the level. A dormant entity
+    // that moves is re-filed under its new cell when its old cell is next
+    // looked at: every frame near the camera, a few cells per frame
+    // elsewhere. add() re-files it at once.
+    //
+    // Entities the player drives are kept out with keepActive(): they tick
+    // every frame wherever they are.
+    class ActivationSystem {
+    public:
+        enum class Tier : uint8_t { Active, Reduced, Dormant };
+
+        struct Settings {
+            float activeRadius = 1024.0f;  // pixels from the view center
+            float reducedRadius = 2048.0f;
+            float hysteresis = 256.0f;
+            uint32_t reducedInterval = 4;  // Reduced entities tick every Nth frame
+            float cellSize = 512.0f;       // dormant bucket size
+            int toggleBudgetPerFrame = 256; // bodies enabled or disabled per update
+            size_t recheckCellsPerFrame = 8; // far dormant cells checked for moved entities
+        };
+
+        ActivationSystem(Registry& registry, PhysicsSystem& physics);
+
+        // Sorts every entity with a Transform into a tier around the camera.
+        // Call after loading; entities spawned later go through add().
+        void rebuild(const Camera& camera);
+        void add(Entity e);
+        // Takes `e` out of tiering for good: it reports Active, ticks every
+        // frame and its body stays enabled, and add() skips it. For player-
+        // or input-driven entities. Call after rebuild(), which drops it.
+        void keepActive(Entity e);
+        void clear();
+
+        // Once per frame, while the physics world is not stepping.
+        void update(const Camera& camera);
+
+        Tier tierOf(Entity e) const;
+        // Whether gameplay should update `e` this frame. Reduced entities are
+        // staggered by index so their ticks spread over the interval; they
+        // should advance by getTickDt.
+        bool shouldTick(Entity e) const;
+        float getTickDt(Entity e, float dt) const;
+
+        // Active and Reduced entities, in no particular order.
+        const std::vector<Entity>& getAwake() const { return awake; }
+        size_t getActiveCount() const { return activeCount; }
+        size_t getReducedCount() const { return awake.size() - activeCount; }
+        size_t getDormantCount() const { return dormantCount; }
+
+        Settings settings;
+
+    private:
+        static constexpr uint8_t Unmanaged = 0xFF;
+        static constexpr uint8_t Pinned = 0xFE; // keepActive()
+        static constexpr uint32_t NoSlot = 0xFFFFFFFFu;
+
+        static int64_t keyFor(int x, int y) { return (int64_t(x) << 32) ^ (uint32_t)y; }
+        glm::ivec2 cellOf(const glm::vec2& position) const;
+        bool isManaged(Entity e) const;
+        // Only moving bodies are toggled; static ones cost nothing per step.
+        bool isSimulated(Entity e) const;
+        void place(Entity e, const glm::vec2& position);
+        void setTier(Entity e, uint8_t tier);
+        void wake(Entity e, Tier tier);
+        void sleep(Entity e, const glm::vec2& position);
+        void forget(Entity e);
+        // Whether a dormant cell's entry for `e` stays; queues moved entities
+        // for re-filing and forgets dead ones.
+        bool keepInCell(Entity e, const glm::ivec2& cell);
+
+        Registry& registry;
+        PhysicsSystem& physics;
+
+        // By entity index; owners guards against reused indices.
+        std::vector<Entity> owners;
+        std::vector<uint8_t> tiers;
+        std::vector<uint32_t> awakeSlot; // into awake
+        std::vector<Entity> awake;
+        std::unordered_map<int64_t, std::vector<Entity>> dormantCells;
+        std::vector<int64_t> recheckKeys; // far cells left to recheck this round
+        std::vector<Entity> moved;        // dormant entities to re-file
+        size_t activeCount = 0;
+        size_t dormantCount = 0;
+        uint32_t frame = 0;
+        glm::vec2 center{ 0.0f };
+    };
+
+}
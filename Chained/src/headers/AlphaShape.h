@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Chained {
+
+    // Matches b2_maxPolygonVertices; pieces never exceed it.
+    constexpr size_t MaxPieceVertices = 8;
+
+    // Collision outline of a sprite as convex pieces, counter-clockwise with
+    // y up, in pixels relative to the sprite's center. Empty when the sprite
+    // has no opaque pixels.
+    struct SliceShape {
+        std::vector<std::vector<glm::vec2>> pieces;
+        glm::vec2 size{ 0.0f }; // sprite size the pieces were traced at
+        bool approximated = false; // an outline could not be split and is its bounding box
+    };
+
+    // Traces the opaque pixels of an RGBA image region, simplifies each
+    // outline to within `tolerance` pixels and splits it into convex pieces.
+    // `rgba` points at the region's bottom-left pixel, rows run bottom-up
+    // `stride` bytes apart (GL texture order). Holes are filled, since a
+    // collider only needs the outside.
+    SliceShape buildAlphaShape(const uint8_t* rgba, int width, int height, size_t stride,
+                               uint8_t threshold = 128, float tolerance = 1.0f);
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Registry.h"
+#include "JobSystem.h"
+#include "SpriteAtlas.h"
+#include "ActivationSystem.h"
+
+namespace Chained {
+
+    using ClipHandle = uint32_t;
+    constexpr ClipHandle InvalidClip = 0xFFFFFFFFu;
+
+    // One clip's run of steps in the flattened tables. Directions are
+    // unrolled at load (a ping-pong tag stores its way back too), so playing
+    // any clip is a lookup by elapsed milliseconds.
+    struct AnimationClip {
+        std::string name;
+        uint32_t first = 0;   // first step in the flattened tables
+        uint32_t count = 0;
+        uint32_t cycleMs = 0; // one pass over the steps
+        uint32_t repeat = 0;  // passes before holding the last step; 0 loops
+    };
+
+    // Plays Aseprite animations from one atlas on entities with an Animator.
+    // Clips come from the atlas's frameTags, or one clip of every frame when
+    // it has none. Each update culls the packed Animator array against the
+    // view and evaluates only visible entities, in parallel ranges; off-screen
+    // entities are not ticked at all and come back at the right frame since
+    // playback is a function of the start time.
+    class AnimationSystem {
+    public:
+        AnimationSystem(Registry& registry, const SpriteAtlas& atlas);
+
+        // Empty name is the first clip.
+        ClipHandle findClip(const std::string& name) const;
+        const AnimationClip& getClip(ClipHandle clip) const { return clips[clip]; }
+        size_t getClipCount() const { return clips.size(); }
+
+        // Adds or restarts the entity's Animator.
+        void play(Entity e, ClipHandle clip, float speed = 1.0f);
+
+        void advance(float dt) { clock += dt; }
+        double getTime() const { return clock; }
+
+        // Atlas frame of `clip` after `elapsed` seconds of playback.
+        uint32_t sample(ClipHandle clip, double elapsed) const;
+        // The animator's frame right now, whether or not it was updated.
+        uint32_t frameOf(const Animator& animator) const;
+
+        // Marks animators whose current frame overlaps [viewMin, viewMax] and
+        // refreshes their frame. Transform::position is the bottom-left
+        // corner, as for sprites.
+        void update(const glm::vec2& viewMin, const glm::vec2& viewMax, JobSystem* jobs = nullptr);
+        // By Animator pool index, as of the last update.
+        bool isVisible(size_t i) const { return i < visible.size() && visible[i]; }
+
+        // With an activation system, visible Reduced animators refresh their
+        // frame only on their tick and Dormant ones keep the last frame.
+        void setActivation(const ActivationSystem* system) { activation = system; }
+        size_t getVisibleCount() const { return visibleCount; }
+
+        const SpriteAtlas& getAtlas() const { return atlas; }
+
+        static constexpr size_t UPDATE_GRAIN = 1024;
+
+    private:
+        void updateRange(size_t first, size_t last, const glm::vec2& viewMin, const glm::vec2& viewMax);
+
+        Registry& registry;
+        const SpriteAtlas& atlas;
+        const ActivationSystem* activation = nullptr;
+        std::vector<AnimationClip> clips;
+        // Flattened over all clips: atlas frame of each step, and when the
+        // step ends in milliseconds from its clip's start.
+        std::vector<uint32_t> stepFrames;
+        std::vector<uint32_t> stepEnds;
+        std::vector<uint8_t> visible;
+        size_t visibleCount = 0;
+        double clock = 0.0;
+    };
+
+}
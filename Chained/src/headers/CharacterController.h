@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Registry.h"
+#include "JobSystem.h"
+#include "ActivationSystem.h"
+
+namespace Chained {
+
+    // Which sides of a character touched a solid tile during its last move.
+    enum CharacterContact : uint8_t {
+        ContactLeft = 1 << 0,
+        ContactRight = 1 << 1,
+        ContactBelow = 1 << 2,
+        ContactAbove = 1 << 3,
+    };
+
+    // Solid/empty flags on a regular grid. Tile (x, y) covers
+    // origin + [x, x + 1) * tileSize by origin + [y, y + 1) * tileSize, rows
+    // bottom-up like the rest of the world.
+    struct TileGrid {
+        glm::vec2 origin{ 0.0f };
+        float tileSize = 32.0f;
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> solid; // width * height, row-major
+        bool solidOutside = true;   // the grid's border acts as a wall
+
+        void resize(int w, int h) {
+            width = w;
+            height = h;
+            solid.assign(size_t(w) * size_t(h), 0);
+        }
+        bool isSolid(int x, int y) const {
+            if (x < 0 || y < 0 || x >= width || y >= height) return solidOutside;
+            return solid[size_t(y) * size_t(width) + size_t(x)] != 0;
+        }
+        void setSolid(int x, int y, bool value) {
+            if (x < 0 || y < 0 || x >= width || y >= height) return;
+            solid[size_t(y) * size_t(width) + size_t(x)] = value ? 1 : 0;
+        }
+    };
+
+    // Kinematic movement for players and simple NPCs that never enter Box2D.
+    // Each update integrates CharacterBody::velocity and sweeps the box along
+    // x, then y, stopping flush against the first solid tile in its path, so
+    // no speed can tunnel through a wall. Blocked axes lose their velocity.
+    // Characters do not collide with each other or with physics bodies.
+    class CharacterController {
+    public:
+        struct Settings {
+            glm::vec2 gravity{ 0.0f };   // pixels per second squared; zero for top-down
+            float skin = 0.01f;          // pixels; boxes flush with a tile do not count as overlapping it
+        };
+
+        explicit CharacterController(Registry& registry);
+
+        // Moves every entity with a CharacterBody and a Transform. Characters
+        // are independent, so large sets are split across the job system.
+        void update(float dt, const TileGrid& grid, JobSystem* jobs = nullptr);
+
+        // With an activation system, Reduced characters move every few
+        // frames by the accumulated dt and Dormant ones not at all.
+        void setActivation(const ActivationSystem* system) { activation = system; }
+
+        // Moves one box by `delta` against the grid and returns the reached
+        // center. Also usable for one-off probes.
+        glm::vec2 move(const TileGrid& grid, glm::vec2 center, glm::vec2 halfExtents,
+                       glm::vec2 delta, uint8_t& contacts) const;
+
+        Settings settings;
+
+        static constexpr size_t UPDATE_GRAIN = 256;
+
+    private:
+        // Sweeps along one axis; returns the travelled distance.
+        float sweep(const TileGrid& grid, const glm::vec2& center, const glm::vec2& halfExtents,
+                    int axis, float delta) const;
+        bool isGrounded(const TileGrid& grid, const glm::vec2& center, const glm::vec2& halfExtents) const;
+        void updateRange(size_t first, size_t last, float dt, const TileGrid& grid);
+
+        Registry& registry;
+        const ActivationSystem* activation = nullptr;
+    };
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Chained {
+
+    // Axis-aligned box, in pixels.
+    struct MergeRect {
+        glm::vec2 min;
+        glm::vec2 max;
+    };
+
+    // One connected region of boxes as closed loops: its outer boundary and
+    // one loop per hole. Loops are wound with the empty side to the right of
+    // each edge (b2Cross(edge, 1)), which b2ChainShape::CreateLoop treats as
+    // the colliding side. Collinear points are removed.
+    struct MergedRegion {
+        std::vector<std::vector<glm::vec2>> loops;
+        std::vector<uint32_t> rects; // indices of the input boxes it covers
+        glm::vec2 min;
+        glm::vec2 max;
+    };
+
+    // Unions boxes that overlap or share an edge and traces the outline of
+    // each connected region. Coordinates closer than `snap` are treated as
+    // equal, so boxes laid out on a grid with float noise still join up.
+    // Boxes touching only at a corner end up in separate regions. Each group
+    // of touching boxes is traced on a grid of its distinct coordinates; a
+    // group whose grid would exceed MERGE_MAX_GRID_CELLS (a long diagonal
+    // staircase, say) is returned unmerged, i.e. in no region.
+    constexpr size_t MERGE_MAX_GRID_CELLS = size_t(1) << 22;
+    std::vector<MergedRegion> mergeRects(const std::vector<MergeRect>& rects, float snap = 0.5f);
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "types.h"
+#include "StringTable.h"
+
+class b2Body;
+
+namespace Chained {
+
+    // Stable entity handle. The index addresses the registry's sparse arrays and
+    // the generation changes every time a slot is recycled, so stale handles
+    // held across a delete simply stop resolving.
+    struct Entity {
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+        uint32_t index = InvalidIndex;
+        uint32_t generation = 0;
+
+        bool isNull() const { return index == InvalidIndex; }
+        bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const Entity& other) const { return !(*this == other); }
+
+        // Packed form for places that only carry an integer (Box2D user data).
+        uint64_t pack() const { return (uint64_t(generation) << 32) | index; }
+        static Entity unpack(uint64_t packed) { return { uint32_t(packed & 0xFFFFFFFFu), uint32_t(packed >> 32) }; }
+    };
+
+    constexpr Entity NullEntity{};
+
+    // --- Hot components: small, packed and iterated every frame ---
+
+    struct Transform {
+        glm::vec2 position{};
+        float rotation = 0.0f;
+        glm::vec2 scale{ 1, 1 };
+    };
+
+    struct Sprite {
+        int assetId = 0;
+        SliceHandle slice = InvalidSlice; // resolved once the registry has an atlas
+        bool baked = false; // drawn from its chunk's sprite list (WorldStreamer::record)
+    };
+
+    struct PhysicsHandle {
+        b2Body* body = nullptr;
+    };
+
+    // Moved by CharacterController against a tile grid instead of Box2D.
+    // The box is centered on Transform::position, like a collider.
+    struct CharacterBody {
+        glm::vec2 halfExtents{ 16.0f, 16.0f }; // pixels
+        glm::vec2 velocity{ 0.0f };            // pixels per second
+        uint8_t contacts = 0;                  // CharacterContact flags from the last move
+        bool grounded = false;                 // solid tile directly below
+    };
+
+    // Playback of an AnimationSystem clip. State is just the start time, so
+    // the frame can be worked out for any moment without ticking; `frame`
+    // caches the atlas frame from the last update that saw the entity.
+    struct Animator {
+        uint32_t clip = 0;
+        float speed = 1.0f;
+        double startTime = 0.0; // on the AnimationSystem clock, seconds
+        uint32_t frame = 0;     // index into the atlas's ordered frames
+    };
+
+    struct NameId {
+        StringId id = InvalidStringId;
+    };
+
+    // --- Cold components: only read at body creation and by the editor ---
+
+    struct Collider {
+        PhysicsBody desc;
+    };
+
+}
@@ -3,25 +3,26 @@
 #pragma once
 #include <box2d/box2d.h>
 #include <glm/glm.hpp>
-#include <imgui.h>
+#include "LineBatch.h"
+#include "SpriteKernel.h"
 
+// Box2D debug output expanded into a LineList in world pixels. Nothing is
+// drawn here; hand the list to a LineBatch (or a FramePacket) afterwards.
 class DebugDraw : public b2Draw {
 public:
     static constexpr float PHYSICS_SCALE = 32.0f;
-    
-    DebugDraw() {
+
+    explicit DebugDraw(Chained::LineList* lines = nullptr) : lines(lines) {
         SetFlags(b2Draw::e_shapeBit);
     }
 
+    void setTarget(Chained::LineList* target) { lines = target; }
+
     void DrawPolygon(const b2Vec2* vertices, int32 vertexCount, const b2Color& color) override {
-        ImU32 col = ImGui::GetColorU32(ImVec4(color.r, color.g, color.b, color.a));
+        if (!lines || vertexCount < 2) return;
+        uint32_t col = toColor(color);
         for (int i = 0; i < vertexCount; ++i) {
-            const b2Vec2& v1 = vertices[i];
-            const b2Vec2& v2 = vertices[(i + 1) % vertexCount];
-            // Convert from Box2D meters to screen pixels
-            ImVec2 screenV1(v1.x * PHYSICS_SCALE, v1.y * PHYSICS_SCALE);
-            ImVec2 screenV2(v2.x * PHYSICS_SCALE, v2.y * PHYSICS_SCALE);
-            ImGui::GetBackgroundDrawList()->AddLine(screenV1, screenV2, col, 2.0f);
+            lines->line(toPixels(vertices[i]), toPixels(vertices[(i + 1) % vertexCount]), col);
         }
     }
 
@@ -30,26 +31,39 @@ public:
     }
 
     void DrawCircle(const b2Vec2& center, float radius, const b2Color& color) override {
-        ImU32 col = ImGui::GetColorU32(ImVec4(color.r, color.g, color.b, color.a));
-        // Convert from Box2D meters to screen pixels
-        ImVec2 screenCenter(center.x * PHYSICS_SCALE, center.y * PHYSICS_SCALE);
-        float screenRadius = radius * PHYSICS_SCALE;
-        ImGui::GetBackgroundDrawList()->AddCircle(screenCenter, screenRadius, col, 32, 2.0f);
+        if (!lines) return;
+        lines->circle(toPixels(center), radius * PHYSICS_SCALE, toColor(color));
     }
 
     void DrawSolidCircle(const b2Vec2& center, float radius, const b2Vec2& axis, const b2Color& color) override {
+        if (!lines) return;
         DrawCircle(center, radius, color);
+        // Spoke so rotation is visible.
+        lines->line(toPixels(center), toPixels(center + radius * axis), toColor(color));
     }
 
     void DrawSegment(const b2Vec2& p1, const b2Vec2& p2, const b2Color& color) override {
-        ImU32 col = ImGui::GetColorU32(ImVec4(color.r, color.g, color.b, color.a));
-        // Convert from Box2D meters to screen pixels
-        ImVec2 screenP1(p1.x * PHYSICS_SCALE, p1.y * PHYSICS_SCALE);
-        ImVec2 screenP2(p2.x * PHYSICS_SCALE, p2.y * PHYSICS_SCALE);
-        ImGui::GetBackgroundDrawList()->AddLine(screenP1, screenP2, col, 2.0f);
+        if (!lines) return;
+        lines->line(toPixels(p1), toPixels(p2), toColor(color));
     }
 
     void DrawTransform(const b2Transform& xf) override {
-        // Optional: draw axis lines for body transforms
+        if (!lines) return;
+        const float axisLength = 0.4f;
+        b2Vec2 xAxis = xf.p + axisLength * b2Vec2(xf.q.c, xf.q.s);
+        b2Vec2 yAxis = xf.p + axisLength * b2Vec2(-xf.q.s, xf.q.c);
+        lines->line(toPixels(xf.p), toPixels(xAxis), Chained::packColor(glm::vec3(1.0f, 0.0f, 0.0f)));
+        lines->line(toPixels(xf.p), toPixels(yAxis), Chained::packColor(glm::vec3(0.0f, 1.0f, 0.0f)));
+    }
+
+    void DrawPoint(const b2Vec2& p, float size, const b2Color& color) override {
+        if (!lines) return;
+        lines->cross(toPixels(p), size * 0.5f, toColor(color));
     }
+
+private:
+    static glm::vec2 toPixels(const b2Vec2& v) { return { v.x * PHYSICS_SCALE, v.y * PHYSICS_SCALE }; }
+    static uint32_t toColor(const b2Color& c) { return Chained::packColor(glm::vec3(c.r, c.g, c.b), c.a); }
+
+    Chained::LineList* lines;
 };
@@ -10,6 +10,8 @@
 #include "SpriteAtlas.h"
 #include "../headers/Camera.h"
 #include "../headers/types.h"
+#include "../headers/Registry.h"
+#include "../headers/LineBatch.h"
 
 
 namespace Chained {
@@ -34,21 +36,22 @@ namespace Chained {
             AtlasFrame frame;
         };
         void drawCameraBounds();
-        bool isObjectUnderMouse(const SceneObject& obj, const glm::vec2& mouseWorldPos) const;
+        bool isObjectUnderMouse(Entity e, const glm::vec2& mouseWorldPos) const;
         Engine* engine = nullptr;
-        std::vector<SceneObject> objects;
+        Registry registry;
         int selectedAsset = 0;
-        int selectedObjectIndex = -1;
+        Entity selectedEntity = NullEntity;
         bool placementMode = false;
         std::unique_ptr<SpriteRenderer> renderer;
         std::vector<AssetEntry> assetPalette;
         std::shared_ptr<SpriteAtlas> spriteAtlas;
         void saveSceneToJson(const std::string& filename);
         void loadSceneFromJson(const std::string& filename);
-        void DrawDebugLine(glm::vec2 a, glm::vec2 b, glm::vec3 color);
         std::unique_ptr<Chained::Camera> camera;
         std::string currentSceneName;
         ShaderPtr m_shader;
+        std::unique_ptr<LineBatch> lineBatch;
+        LineList colliderLines;
     };
 
 } // namespace Chained
@@ -7,6 +7,8 @@
 #include "GameState.h"
 #include "resourceManager.h"
 #include "spriteRenderer.h"
+#include "JobSystem.h"
+#include "RenderThread.h"
 
 namespace Chained {
     enum class EngineState {
@@ -31,13 +33,26 @@ namespace Chained {
         void exitRunLoop();
 
         GLFWwindow* getWindow() const { return window; }
+        JobSystem& getJobs() { return jobs; }
+
+        // When enabled (F4 toggles it), states that support frame packets are
+        // drawn by a dedicated render thread one frame behind the simulation.
+        void setRenderThreadEnabled(bool enabled) { renderThreadEnabled = enabled; }
+        bool isRenderThreadEnabled() const { return renderThreadEnabled; }
 
     private:
+        void drawProfiler(float deltaTime);
+
         GLFWwindow* window = nullptr;
         std::shared_ptr<Chained::SpriteRenderer> renderer;
+        // Declared before the state so it outlives anything the state waits on.
+        JobSystem jobs;
         std::unique_ptr<GameState> currentState;
         bool initGLFW();
         bool initOpenGL();
         bool keepRunning = true;
+        bool showProfiler = false;
+        bool renderThreadEnabled = false;
+        std::unique_ptr<RenderThread> renderThread;
     };
 }
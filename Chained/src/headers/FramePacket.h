@@ -0,0 +1,103 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+#include "imgui.h"
+#include "LineBatch.h"
+#include "SpriteBatch.h"
+#include "SpriteKernel.h"
+#include "types.h"
+
+namespace Chained {
+
+    // One frame of render work, recorded on the simulation thread and
+    // executed later, possibly by the render thread. Everything it draws is
+    // copied in at record time, so the simulation can keep changing its own
+    // state while the packet executes. Storage is kept across reset() so a
+    // reused packet stops allocating after the first few frames.
+    class FramePacket {
+    public:
+        FramePacket() = default;
+        ~FramePacket();
+
+        FramePacket(const FramePacket&) = delete;
+        FramePacket& operator=(const FramePacket&) = delete;
+
+        void reset();
+
+        // Optional frame setup; a packet without them draws over whatever is bound.
+        void setViewport(int width, int height);
+        void setClearColor(const glm::vec4& color);
+
+        // Sprites between beginSprites and endSprites are drawn through
+        // `batch`, split into runs wherever the texture changes, exactly as
+        // SpriteBatch::draw would split them.
+        void beginSprites(SpriteBatch* batch, const glm::mat4& projection);
+        void drawSprite(const Texture2DPtr& texture, glm::vec2 position, glm::vec2 size,
+                        float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f),
+                        glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+                        glm::vec2 scale = glm::vec2(1.0f));
+        // Appends `count` sprites drawn with `texture` and returns the list
+        // they live in, with `first` set to the index of the first one; the
+        // caller fills [first, first + count) in place, possibly from several
+        // jobs, and sets anyRotated/anyScaled if it needs them. Returns null
+        // outside beginSprites/endSprites.
+        SpriteList* appendSprites(const Texture2DPtr& texture, size_t count, size_t& first);
+        void endSprites();
+
+        // Returns an empty list drawn through `batch` at this point in the
+        // frame. The list stays valid until the packet is reset.
+        LineList& beginLines(LineBatch* batch, const glm::mat4& projection);
+
+        // Arbitrary GL work, run in record order between the other commands.
+        void addCommand(std::function<void()> fn);
+
+        // Copies ImGui's draw lists into the packet. Returns true when ImGui
+        // also asked for texture uploads; the packet then has to finish
+        // executing before the next ImGui::NewFrame touches those textures.
+        bool captureUi(const ImDrawData* drawData);
+
+        // Issues the recorded GL calls. Needs a current context.
+        void execute();
+
+        size_t getSpriteCount() const { return sprites.size(); }
+
+    private:
+        enum class CommandType { Sprites, Lines, Custom };
+        struct Command {
+            CommandType type;
+            size_t index; // into spritePasses, linePasses or custom
+        };
+        struct SpritePass {
+            SpriteBatch* batch;
+            glm::mat4 projection;
+            size_t firstRun;
+            size_t runCount;
+        };
+
+        std::vector<Command> commands;
+        std::vector<SpritePass> spritePasses;
+        std::vector<SpriteBatch::Run> runs;
+        SpriteList sprites; // shared by every pass in the packet
+        std::vector<std::function<void()>> custom;
+
+        struct LinePass {
+            LineBatch* batch;
+            glm::mat4 projection;
+            LineList lines;
+        };
+        std::vector<LinePass> linePasses; // only the first linePassCount are live
+        size_t linePassCount = 0;
+        bool recordingSprites = false;
+
+        int viewportWidth = 0;
+        int viewportHeight = 0;
+        bool clear = false;
+        glm::vec4 clearColor{ 0.0f };
+
+        ImDrawData ui;
+        std::vector<ImDrawList*> uiLists; // owned copies, reused frame to frame
+        bool hasUi = false;
+    };
+
+}
@@ -1,7 +1,12 @@
 #pragma once
 
+struct GLFWwindow;
+
 namespace Chained {
 
+    class FramePacket;
+    class JobSystem;
+
     class GameState {
     public:
         virtual ~GameState() {}
@@ -9,6 +14,22 @@ namespace Chained {
         virtual void onExit() = 0;
         virtual void update(float dt) = 0;
         virtual void render() = 0;
+
+        // States that can describe a whole frame as a FramePacket opt in to
+        // the render thread; Engine then calls record() instead of render(),
+        // and GL calls must not be made from update().
+        virtual bool supportsFramePackets() const { return false; }
+        virtual void record(FramePacket& /*packet*/) {}
+
+        // Set by Engine::run before onEnter.
+        void attachJobs(JobSystem* system) { jobs = system; }
+        // Input should be read through this window: with the render thread
+        // running there is no current context on the simulation thread.
+        void attachWindow(GLFWwindow* engineWindow) { window = engineWindow; }
+
+    protected:
+        JobSystem* jobs = nullptr;
+        GLFWwindow* window = nullptr;
     };
 
 }
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Chained {
+
+    // Completion state shared between the scheduler and whoever holds the
+    // handle. Later jobs can name it as a dependency; wait() blocks on it.
+    struct JobState {
+        std::function<void()> fn;
+        std::atomic<int> pendingDeps{ 0 };
+        std::atomic<bool> done{ false };
+        bool background = false; // scheduleBackground: never run inside a wait()
+        std::mutex mutex; // guards continuations and the transition to done
+        std::condition_variable finished; // signalled once done, for parked waiters
+        std::vector<std::shared_ptr<JobState>> continuations;
+    };
+    using JobHandle = std::shared_ptr<JobState>;
+
+    // Work-stealing scheduler. Every worker owns a deque: it pushes and pops
+    // its own jobs at the back and idle workers steal from the front of the
+    // others. The thread that creates the system is worker 0 and runs its
+    // own queued jobs whenever it waits, so the main thread does not block
+    // idly; once it has none, and on threads the system does not own, a
+    // wait parks on the handle. Long jobs such as file loads go through
+    // scheduleBackground so they only ever run on background workers.
+    class JobSystem {
+    public:
+        struct WorkerStats {
+            double busyMs = 0.0;
+            double utilization = 0.0; // busy time / frame time, 0..1
+            uint64_t jobs = 0;
+            uint64_t steals = 0;
+        };
+
+        // 0 picks hardware_concurrency - 1 background workers.
+        explicit JobSystem(unsigned backgroundThreads = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // The job runs once every dependency has finished. Null handles are ignored.
+        JobHandle schedule(std::function<void()> fn, std::initializer_list<JobHandle> deps = {});
+        JobHandle schedule(std::function<void()> fn, const std::vector<JobHandle>& deps);
+        // Like schedule, but the job is queued on workers 1..N only and never
+        // run by a waiting thread, so IO and parsing cannot stall a frame.
+        JobHandle scheduleBackground(std::function<void()> fn, const std::vector<JobHandle>& deps = {});
+
+        // Calls fn(begin, end) over [0, count) in ranges whose size is a
+        // multiple of `grain` (the last may be shorter). The returned handle
+        // finishes when every range has.
+        JobHandle parallelFor(size_t count, size_t grain, std::function<void(size_t, size_t)> fn,
+                              const std::vector<JobHandle>& deps = {});
+
+        // Blocks until `handle` is done. Worker threads run their own queued
+        // jobs, oldest first and background jobs excepted, while they wait;
+        // with none left, and on other threads, the caller sleeps until the
+        // handle finishes (rechecking its queue every millisecond).
+        void wait(const JobHandle& handle);
+        static bool isDone(const JobHandle& handle) {
+            return !handle || handle->done.load(std::memory_order_acquire);
+        }
+
+        size_t workerCount() const { return workers.size(); }
+
+        // Closes the current measurement window; called once per frame by Engine.
+        void endFrame();
+        const std::vector<WorkerStats>& frameStats() const { return stats; }
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<JobHandle> queue;
+            std::atomic<uint64_t> busyNs{ 0 };
+            std::atomic<uint64_t> jobs{ 0 };
+            std::atomic<uint64_t> steals{ 0 };
+        };
+
+        JobHandle submit(JobHandle job, const std::vector<JobHandle>& deps);
+        void workerLoop(unsigned index);
+        size_t currentWorker() const;
+        void push(JobHandle job);
+        JobHandle pop(size_t index);
+        JobHandle popOldest(size_t index); // own queue only, front first, no background jobs
+        void execute(const JobHandle& job, size_t index);
+        void complete(const JobHandle& job);
+
+        std::vector<std::unique_ptr<Worker>> workers; // [0] is the owning thread
+        std::vector<std::thread> threads;
+        std::atomic<int> queued{ 0 };
+        std::atomic<bool> running{ true };
+        std::mutex sleepMutex;
+        std::condition_variable sleepCv;
+
+        std::chrono::steady_clock::time_point frameStart;
+        std::vector<WorkerStats> stats;
+    };
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "types.h"
+
+namespace Chained {
+
+    struct LineVertex {
+        float x, y;
+        uint32_t color; // RGBA8, see packColor
+    };
+
+    // World-space line segments collected on the CPU. Shapes are expanded to
+    // segments as they are added, so a list can be filled on any thread and
+    // handed to a LineBatch (or a FramePacket) later.
+    struct LineList {
+        std::vector<LineVertex> vertices; // two per segment
+
+        void line(glm::vec2 a, glm::vec2 b, uint32_t color);
+        // Closed outline through `count` points.
+        void polygon(const glm::vec2* points, size_t count, uint32_t color);
+        void box(glm::vec2 center, glm::vec2 halfSize, float rotation, uint32_t color);
+        void circle(glm::vec2 center, float radius, uint32_t color);
+        void cross(glm::vec2 center, float halfSize, uint32_t color);
+
+        void clear() { vertices.clear(); }
+        void reserve(size_t segments) { vertices.reserve(segments * 2); }
+        size_t size() const { return vertices.size() / 2; }
+    };
+
+    // Draws LineLists as GL_LINES through a small dedicated shader, streaming
+    // vertices into one buffer. A list of any length costs one draw call per
+    // buffer's worth of segments.
+    class LineBatch {
+    public:
+        explicit LineBatch(ShaderPtr shader, size_t maxSegmentsPerDraw = 32768);
+        ~LineBatch();
+
+        void draw(const glm::mat4& projection, const LineList& lines);
+
+        size_t getDrawCallCount() const { return m_drawCalls; }
+
+    private:
+        ShaderPtr m_shader;
+        GLuint m_vao = 0;
+        GLuint m_vbo = 0;
+        size_t m_capacity; // vertices
+        size_t m_drawCalls = 0;
+    };
+
+}
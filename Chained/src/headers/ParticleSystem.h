@@ -0,0 +1,115 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "FramePacket.h"
+#include "JobSystem.h"
+#include "SpriteAtlas.h"
+
+namespace Chained {
+
+    // A value at normalized particle age t in [0, 1]. Curves are linear
+    // between keys sorted by t and hold the end values outside them.
+    struct ParticleKey {
+        float t = 0.0f;
+        glm::vec4 value{ 1.0f };
+    };
+    using ParticleCurve = std::vector<ParticleKey>;
+
+    struct ParticleEmitterDesc {
+        glm::vec2 position{ 0.0f };
+        glm::vec2 area{ 0.0f };           // spawn box size centered on the position
+        float rate = 100.0f;              // particles per second
+        size_t burst = 0;                 // spawned at once when the emitter is added
+        size_t capacity = 0;              // 0 sizes the pool for rate and lifetime
+        glm::vec2 lifetime{ 1.0f, 1.0f }; // seconds, min and max
+        glm::vec2 speed{ 50.0f, 100.0f }; // pixels per second, min and max
+        float direction = 1.5707963f;     // radians, 0 is +x and y is up
+        float spread = 6.2831853f;        // full cone width in radians
+        glm::vec2 spin{ 0.0f };           // radians per second, min and max
+        glm::vec2 gravity{ 0.0f };        // pixels per second squared
+        float drag = 0.0f;                // velocity decays by exp(-drag * dt)
+        ParticleCurve size;               // x scales the frame's pixel size; empty is 1
+        ParticleCurve color;              // RGBA multiplied into the frame; empty is white
+        std::string clip;                 // atlas frame tag; empty plays every frame
+        float frameRate = 0.0f;           // 0 plays the clip once over each particle's life
+    };
+
+    using EmitterHandle = uint32_t;
+
+    // CPU particles drawn as sprites. Each emitter owns a fixed pool kept as
+    // structure-of-arrays with live particles packed at the front, like
+    // ProjectileSystem: integration is one SIMD pass over contiguous floats
+    // and expiry is a swap with the last one. Size and colour curves are
+    // baked to tables when the emitter is added, so a particle's look is a
+    // lookup by age. record() writes the sprites straight into the packet's
+    // sprite list in parallel ranges, one texture run per emitter, and the
+    // batch builds vertices with the same kernel as every other sprite.
+    class ParticleSystem {
+    public:
+        // The atlas must outlive the emitter.
+        EmitterHandle addEmitter(const ParticleEmitterDesc& desc, const SpriteAtlas& atlas);
+        void clear();
+
+        void setPosition(EmitterHandle emitter, const glm::vec2& position);
+        void setRate(EmitterHandle emitter, float rate);
+        // Spawns up to `count` particles now; returns how many fit.
+        size_t burst(EmitterHandle emitter, size_t count);
+
+        // Spawns, moves and retires particles of every emitter.
+        void update(float dt, JobSystem* jobs);
+        // Emitters whose particles may overlap [viewMin, viewMax] add one run
+        // each to the current sprite pass.
+        void record(FramePacket& packet, const glm::vec2& viewMin, const glm::vec2& viewMax, JobSystem* jobs) const;
+
+        size_t getEmitterCount() const { return emitters.size(); }
+        size_t size() const; // live particles over all emitters
+
+        static constexpr size_t INTEGRATE_GRAIN = 4096;
+        static constexpr size_t WRITE_GRAIN = 4096;
+        static constexpr size_t CURVE_STEPS = 64;
+
+    private:
+        struct FrameSprite {
+            glm::vec2 size;
+            glm::vec4 uvRect;
+        };
+
+        struct Emitter {
+            ParticleEmitterDesc desc;
+            Texture2DPtr texture;
+            std::vector<FrameSprite> frames; // the clip, in play order
+            std::array<float, CURVE_STEPS> sizeTable;
+            std::array<uint32_t, CURVE_STEPS> colorTable;
+            bool rotates = false;
+            float reach = 0.0f;     // widest particle's half diagonal
+            float spawnCarry = 0.0f;
+            uint32_t rng = 0x9E3779B9u;
+
+            // Per particle, [0, count) live.
+            size_t count = 0;
+            std::vector<float> x, y;
+            std::vector<float> vx, vy;
+            std::vector<float> age;     // normalized, expired at 1
+            std::vector<float> invLife; // 1 / lifetime in seconds
+            std::vector<float> rotation, spin;
+            // Bounds of the live particle centers after the last update.
+            glm::vec2 boundsMin{ INFINITY }, boundsMax{ -INFINITY };
+
+            float random();
+        };
+
+        static void spawn(Emitter& e, size_t count);
+        static void integrate(Emitter& e, size_t first, size_t last, float dt);
+        static void remove(Emitter& e, size_t i);
+        static void writeSprites(const Emitter& e, SpriteList& out, size_t dst, size_t first, size_t last);
+
+        std::vector<std::unique_ptr<Emitter>> emitters;
+    };
+
+}
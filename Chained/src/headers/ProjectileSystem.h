@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Components.h"
+#include "JobSystem.h"
+#include "physics.h"
+
+namespace Chained {
+
+    struct ProjectileDesc {
+        glm::vec2 position{ 0.0f };
+        glm::vec2 velocity{ 0.0f };   // pixels per second
+        float radius = 0.0f;          // 0 casts a ray instead of a circle
+        float lifetime = 2.0f;        // seconds
+        QueryFilter filter;           // set ignore to the shooter
+        uint32_t userData = 0;        // passed through to the hit, e.g. damage
+    };
+
+    // One projectile that struck a fixture this update. The projectile is
+    // already gone by the time the event is read.
+    struct ProjectileHit {
+        Entity shooter = NullEntity;  // the desc's filter.ignore
+        Entity target = NullEntity;
+        glm::vec2 point{ 0.0f };
+        glm::vec2 normal{ 0.0f };
+        glm::vec2 velocity{ 0.0f };
+        uint32_t userData = 0;
+    };
+
+    // Projectiles kept outside Box2D as structure-of-arrays in a fixed pool.
+    // Live projectiles are packed at the front, so integration is one SIMD
+    // pass over contiguous floats and removal is a swap with the last one.
+    // Collision is a swept query per projectile against the physics worlds,
+    // batched through PhysicsSystem::raycast and shapeCast, whose candidate
+    // lists are per-thread scratch. Every buffer is sized in the constructor,
+    // so spawning and updating do not allocate per projectile (only the job
+    // batches do); spawn fails once the pool is full.
+    class ProjectileSystem {
+    public:
+        explicit ProjectileSystem(size_t capacity = 16384);
+
+        bool spawn(const ProjectileDesc& desc);
+        void clear();
+
+        // Moves every projectile, retires expired ones and resolves hits.
+        // The physics world must not be stepping (call between finishStep
+        // and beginStep); queries wait for it otherwise.
+        void update(float dt, PhysicsSystem& physics, JobSystem* jobs);
+
+        // Hits from the last update, in no particular order.
+        const std::vector<ProjectileHit>& getHits() const { return hits; }
+
+        void setGravity(const glm::vec2& g) { gravity = g; }
+
+        size_t size() const { return count; }
+        size_t capacity() const { return x.size(); }
+        glm::vec2 getPosition(size_t i) const { return { x[i], y[i] }; }
+        float getRadius(size_t i) const { return radius[i]; }
+
+        static constexpr size_t INTEGRATE_GRAIN = 4096;
+
+    private:
+        void integrate(size_t first, size_t last, float dt);
+        void remove(size_t i);
+
+        size_t count = 0;
+        glm::vec2 gravity{ 0.0f };
+
+        // Per projectile, [0, count) live.
+        std::vector<float> x, y;
+        std::vector<float> prevX, prevY; // position before this update's move
+        std::vector<float> vx, vy;
+        std::vector<float> life;
+        std::vector<float> radius;
+        std::vector<QueryFilter> filter;
+        std::vector<uint32_t> userData;
+
+        // Query scratch, split by shape; castSlot maps results back to slots.
+        std::vector<RayQuery> rays;
+        std::vector<ShapeCastQuery> casts;
+        std::vector<uint32_t> raySlot, castSlot;
+        std::vector<QueryHit> rayHits, castHits;
+        std::vector<QueryHit> slotHit; // merged per slot
+        std::vector<ProjectileHit> hits;
+    };
+
+}
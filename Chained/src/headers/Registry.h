@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Components.h"
+#include "StringTable.h"
+#include "types.h"
+
+namespace Chained {
+
+    // Sparse set: components live packed in `dense`, `owners[i]` is the entity
+    // that owns dense[i], and `sparse[entity.index]` points back into dense.
+    // Removal swaps the last element into the hole, so iteration never skips.
+    template<typename T>
+    class ComponentPool {
+    public:
+        static constexpr uint32_t Npos = 0xFFFFFFFFu;
+
+        T& add(Entity e, const T& value = T{}) {
+            if (e.index >= sparse.size()) sparse.resize(e.index + 1, Npos);
+            uint32_t slot = sparse[e.index];
+            if (slot != Npos) {
+                dense[slot] = value;
+                owners[slot] = e;
+                return dense[slot];
+            }
+            sparse[e.index] = static_cast<uint32_t>(dense.size());
+            dense.push_back(value);
+            owners.push_back(e);
+            return dense.back();
+        }
+
+        void remove(Entity e) {
+            if (!has(e)) return;
+            uint32_t slot = sparse[e.index];
+            uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+            if (slot != last) {
+                dense[slot] = std::move(dense[last]);
+                owners[slot] = owners[last];
+                sparse[owners[slot].index] = slot;
+            }
+            dense.pop_back();
+            owners.pop_back();
+            sparse[e.index] = Npos;
+        }
+
+        bool has(Entity e) const {
+            return e.index < sparse.size() && sparse[e.index] != Npos && owners[sparse[e.index]] == e;
+        }
+
+        T* get(Entity e) { return has(e) ? &dense[sparse[e.index]] : nullptr; }
+        const T* get(Entity e) const { return has(e) ? &dense[sparse[e.index]] : nullptr; }
+
+        void clear() {
+            dense.clear();
+            owners.clear();
+            sparse.clear();
+        }
+
+        size_t size() const { return dense.size(); }
+        T* data() { return dense.data(); }
+        const T* data() const { return dense.data(); }
+        Entity owner(size_t i) const { return owners[i]; }
+        const std::vector<Entity>& entities() const { return owners; }
+
+        typename std::vector<T>::iterator begin() { return dense.begin(); }
+        typename std::vector<T>::iterator end() { return dense.end(); }
+        typename std::vector<T>::const_iterator begin() const { return dense.begin(); }
+        typename std::vector<T>::const_iterator end() const { return dense.end(); }
+
+    private:
+        std::vector<T> dense;
+        std::vector<Entity> owners;
+        std::vector<uint32_t> sparse;
+    };
+
+    class SpriteAtlas;
+
+    class Registry {
+    public:
+        Entity create();
+        // Does not touch Box2D; release bodies through PhysicsSystem::removeEntity first.
+        void destroy(Entity e);
+        bool alive(Entity e) const;
+        void clear();
+        size_t count() const { return aliveCount; }
+
+        // Builds an entity from a loaded SceneObject and back again for saving.
+        Entity spawn(const SceneObject& obj);
+        SceneObject toSceneObject(Entity e) const;
+
+        StringId internName(const std::string& name) { return names.intern(name); }
+        const std::string& nameOf(StringId id) const { return names.str(id); }
+        const std::string& nameOf(Entity e) const;
+        StringTable& strings() { return names; }
+
+        // Resolves every sprite's slice handle from its name, now and for each
+        // entity spawned later. Pass nullptr to stop resolving.
+        void bindAtlas(const SpriteAtlas* atlas);
+        const SpriteAtlas* getAtlas() const { return atlas; }
+
+        ComponentPool<Transform> transforms;
+        ComponentPool<Sprite> sprites;
+        ComponentPool<PhysicsHandle> bodies;
+        ComponentPool<NameId> nameIds;
+        ComponentPool<Collider> colliders;
+        ComponentPool<CharacterBody> characters;
+        ComponentPool<Animator> animators;
+
+    private:
+        std::vector<uint32_t> generations;
+        std::vector<uint32_t> freeIndices;
+        size_t aliveCount = 0;
+
+        SliceHandle sliceFor(StringId name);
+
+        StringTable names;
+        const SpriteAtlas* atlas = nullptr;
+        std::vector<SliceHandle> sliceByName; // indexed by StringId, filled lazily
+    };
+
+}
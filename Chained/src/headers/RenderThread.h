@@ -0,0 +1,62 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "FramePacket.h"
+
+struct GLFWwindow;
+
+namespace Chained {
+
+    // Owns the window's GL context on a dedicated thread and executes frame
+    // packets there. Two packets alternate: the simulation records frame N+1
+    // into one while the render thread submits and presents frame N from the
+    // other, so a slow submit no longer delays the next simulation tick.
+    class RenderThread {
+    public:
+        struct Stats {
+            double executeMs = 0.0; // render thread: packet execution and swap
+            double waitMs = 0.0;    // simulation thread: blocked on the render thread
+        };
+
+        explicit RenderThread(GLFWwindow* window);
+        ~RenderThread();
+
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        // Moves the context from the calling thread, which must have it
+        // current, to the render thread.
+        void start();
+        // Executes anything still queued, then makes the context current on
+        // the calling thread again.
+        void stop();
+        bool isRunning() const { return running; }
+
+        // The packet to record the next frame into, already reset. Blocks
+        // while the render thread is still executing it from two frames ago.
+        FramePacket& acquire();
+        // Queues the acquired packet. With `sync`, also waits until it has
+        // been executed and presented.
+        void submit(bool sync = false);
+
+        Stats getStats() const;
+
+    private:
+        void loop();
+
+        GLFWwindow* window;
+        std::thread thread;
+        bool running = false;
+
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        FramePacket packets[2];
+        int writeIndex = 0;
+        int queuedIndex = -1;
+        int executingIndex = -1;
+        bool stopRequested = false;
+        Stats stats;
+    };
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "types.h"
+#include "JobSystem.h"
+
+namespace Chained {
+
+    // Loads scene files with the "objects" array split into ranges that are
+    // parsed and built into SceneObjects as jobs. Everything else in the file
+    // (camera, settings) is parsed normally into `document`. Without a job
+    // system the ranges are parsed in order on the calling thread.
+    class SceneLoader {
+    public:
+        using ObjectList = std::vector<std::unique_ptr<SceneObject>>;
+
+        // Called on the calling thread for each finished range, always in scene
+        // order, while later ranges are still being parsed. Use it for work that
+        // has to stay single-threaded, like b2World::CreateBody.
+        using RangeReadyFn = std::function<void(ObjectList::iterator first, ObjectList::iterator last)>;
+
+        struct SceneData {
+            nlohmann::json document;  // scene file minus the "objects" array
+            ObjectList objects;
+        };
+
+        static bool loadFile(const std::string& filename, SceneData& out, const RangeReadyFn& onRangeReady = nullptr, JobSystem* jobs = nullptr);
+        static bool loadText(const std::string& text, SceneData& out, const RangeReadyFn& onRangeReady = nullptr, JobSystem* jobs = nullptr);
+
+        // Shared by every scene reader and writer so the JSON layout lives in one place.
+        static void parseObject(const nlohmann::json& objJson, SceneObject& obj);
+        static nlohmann::json serializeObject(const SceneObject& obj);
+
+        static constexpr size_t MIN_OBJECTS_PER_RANGE = 64;
+    };
+
+}
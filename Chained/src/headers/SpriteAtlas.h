@@ -2,10 +2,13 @@
 #pragma once
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include "texture2d.h"
 #include <nlohmann/json.hpp>
 #include "../headers/types.h"
+#include "AlphaShape.h"
+#include "JobSystem.h"
 
 namespace Chained {
 
@@ -14,9 +17,30 @@ namespace Chained {
         int duration;
     };
 
+    // A slice as the renderer consumes it, computed once at load: the UV rect
+    // already flipped for the bottom-up GL texture and the size in pixels.
+    struct SliceInfo {
+        glm::vec4 uvRect;
+        glm::vec2 pixelSize;
+    };
+
+    enum class TagDirection { Forward, Reverse, PingPong, PingPongReverse };
+
+    // An Aseprite frameTag: frames [from, to] of the ordered frame table.
+    struct FrameTag {
+        std::string name;
+        int from = 0;
+        int to = 0;
+        TagDirection direction = TagDirection::Forward;
+        int repeat = 0; // plays this many times then holds; 0 loops forever
+    };
+
     class SpriteAtlas {
     public:
-        SpriteAtlas(const std::string& jsonFile);
+        // With a job system the atlas image decodes on a worker while the JSON
+        // frames and slices are read here, and slice shapes are traced in
+        // parallel before the upload.
+        SpriteAtlas(const std::string& jsonFile, JobSystem* jobs = nullptr);
 
         Chained::Texture2DPtr getTexture() const;
         const AtlasFrame& getFrame(const std::string& name) const;
@@ -25,10 +49,30 @@ namespace Chained {
 
         const std::unordered_map<std::string, AtlasFrame>& getAllSlices() const;
 
+        // Name lookup is for load time; draw code keeps the handle.
+        SliceHandle resolveSlice(const std::string& name) const;
+        const SliceInfo& getSliceInfo(SliceHandle handle) const { return m_sliceInfos[handle]; }
+        size_t getSliceCount() const { return m_sliceInfos.size(); }
+        // Convex collision pieces traced from the slice's alpha at load, shared
+        // by every polygon collider that uses the slice.
+        const SliceShape& getSliceShape(SliceHandle handle) const { return m_sliceShapes[handle]; }
+
+        // Frames in Aseprite's timeline order, which frameTags index into.
+        size_t getFrameCount() const { return m_frameInfos.size(); }
+        const SliceInfo& getFrameInfo(size_t index) const { return m_frameInfos[index]; }
+        int getFrameDuration(size_t index) const { return m_frameDurations[index]; } // milliseconds
+        const std::vector<FrameTag>& getFrameTags() const { return m_frameTags; }
+
     private:
         Chained::Texture2DPtr m_texture;
         std::unordered_map<std::string, AtlasFrame> m_frames;
         std::unordered_map<std::string, AtlasFrame> m_slices; // added
+        std::unordered_map<std::string, SliceHandle> m_sliceHandles;
+        std::vector<SliceInfo> m_sliceInfos;
+        std::vector<SliceShape> m_sliceShapes; // by handle
+        std::vector<SliceInfo> m_frameInfos;   // timeline order
+        std::vector<int> m_frameDurations;
+        std::vector<FrameTag> m_frameTags;
     };
 
 } // namespace Chained
@@ -0,0 +1,66 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "Texture2D.h"
+#include "SpriteKernel.h"
+#include "JobSystem.h"
+#include "types.h"
+
+namespace Chained {
+
+    // Collects sprites between begin() and end() and draws them with one call
+    // per texture run. Vertices are produced by the SIMD sprite kernel directly
+    // into a mapped streaming buffer, so there are no per-sprite uniforms.
+    class SpriteBatch {
+    public:
+        // A contiguous range of a SpriteList drawn with one texture.
+        struct Run {
+            Texture2DPtr texture;
+            size_t first = 0;
+            size_t count = 0;
+        };
+
+        explicit SpriteBatch(ShaderPtr shader, size_t maxSpritesPerDraw = 8192);
+        ~SpriteBatch();
+
+        // With a job system, large flushes generate vertices in parallel ranges.
+        void setJobSystem(JobSystem* jobs) { m_jobs = jobs; }
+
+        void begin(const glm::mat4& projection);
+        // Same parameters as SpriteRenderer::DrawSprite, with scale kept
+        // separate so unscaled sprites take the kernel's fast path.
+        void draw(const Texture2DPtr& texture, glm::vec2 position, glm::vec2 size,
+                  float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f),
+                  glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+                  glm::vec2 scale = glm::vec2(1.0f));
+        void end();
+
+        // Draws runs recorded ahead of time (see FramePacket) without going
+        // through begin/draw/end. Resets the counters like begin() does.
+        void submit(const glm::mat4& projection, const SpriteList& sprites, const Run* runs, size_t runCount);
+
+        size_t getDrawCallCount() const { return m_drawCalls; }
+        size_t getSpriteCount() const { return m_spriteCount; }
+
+        // Multiple of 8 so every range keeps whole AVX2 blocks.
+        static constexpr size_t VERTEX_GRAIN = 2048;
+
+    private:
+        void flush();
+        void drawRange(const Texture2DPtr& texture, const SpriteList& sprites, size_t first, size_t count);
+
+        ShaderPtr m_shader;
+        GLuint m_vao = 0;
+        GLuint m_vbo = 0;
+        GLuint m_ebo = 0;
+        size_t m_capacity;
+        JobSystem* m_jobs = nullptr;
+
+        SpriteList m_sprites;
+        Texture2DPtr m_texture;
+        size_t m_drawCalls = 0;
+        size_t m_spriteCount = 0;
+    };
+
+}
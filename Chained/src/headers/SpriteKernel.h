@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Chained {
+
+    // Sprites laid out as structure-of-arrays so the vertex kernel can load
+    // four or eight of each field at once. Rotation is in radians around the
+    // sprite's center, matching SpriteRenderer::DrawSprite.
+    struct SpriteList {
+        std::vector<float> x, y;          // bottom-left corner before rotation
+        std::vector<float> width, height; // base size in pixels
+        std::vector<float> scaleX, scaleY;
+        std::vector<float> rotation;
+        std::vector<float> u, v, uw, vh;  // uv rect, already flipped for GL
+        std::vector<uint32_t> color;      // RGBA8
+
+        // Tracked on push so the kernel can pick a specialized path.
+        bool anyRotated = false;
+        bool anyScaled = false;
+
+        void push(const glm::vec2& position, const glm::vec2& size, float rot,
+                  const glm::vec2& scale, const glm::vec4& uvRect, uint32_t rgba);
+        void clear();
+        void reserve(size_t count);
+        // Grows or shrinks every field, for callers that fill sprites in place.
+        void resize(size_t count);
+        // Copies every sprite into out[at, at + size()), which must exist.
+        void copyTo(SpriteList& out, size_t at) const;
+        size_t size() const { return x.size(); }
+    };
+
+    uint32_t packColor(const glm::vec3& color, float alpha = 1.0f);
+
+    // Per sprite the kernel writes 4 vertices in the order bottom-left,
+    // bottom-right, top-right, top-left into three separate streams:
+    // 8 floats of position, 8 floats of uv and 4 packed colors.
+    struct SpriteVertexStreams {
+        float* positions;
+        float* uvs;
+        uint32_t* colors;
+    };
+
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+    SimdLevel detectSimdLevel();
+    const char* simdLevelName(SimdLevel level);
+
+    // Generates vertices for sprites [first, first + count) of `list` into
+    // `out`, starting at the stream base. Uses the widest instruction set the
+    // CPU supports unless `level` forces a narrower one.
+    void generateSpriteVertices(const SpriteList& list, size_t first, size_t count,
+                                const SpriteVertexStreams& out);
+    void generateSpriteVertices(const SpriteList& list, size_t first, size_t count,
+                                const SpriteVertexStreams& out, SimdLevel level);
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Chained {
+
+    using StringId = uint32_t;
+    constexpr StringId InvalidStringId = 0xFFFFFFFFu;
+
+    // Interns strings into dense integer ids. Ids never change for the lifetime
+    // of the table, so per-frame code compares and indexes by id and only
+    // loading code pays for hashing.
+    class StringTable {
+    public:
+        StringId intern(const std::string& str);
+        // Returns InvalidStringId if the string was never interned.
+        StringId find(const std::string& str) const;
+        const std::string& str(StringId id) const;
+        size_t size() const { return strings.size(); }
+
+    private:
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, StringId> lookup;
+    };
+
+}
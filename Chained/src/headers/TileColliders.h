@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ColliderMerge.h"
+#include "Registry.h"
+#include "TileMap.h"
+#include "physics.h"
+#include "types.h"
+
+namespace Chained {
+
+    // Tiles [x, x + w) x [y, y + h), relative to a chunk's first tile.
+    struct TileRect {
+        int x, y, w, h;
+    };
+
+    // Covers every tile of the chunk whose id is flagged in `solid` (indexed
+    // by TileId) with non-overlapping rectangles: each starts at the first
+    // uncovered solid tile in row order, grows as wide as it can, then as
+    // tall as the full width allows.
+    void greedyMeshChunk(const TileMap::Chunk& chunk, const std::vector<uint8_t>& solid, std::vector<TileRect>& out);
+
+    // Keeps one static body per TileMap chunk, with a box fixture per greedy
+    // rectangle of solid tiles instead of one per tile. sync() compares chunk
+    // revisions, so a tile edit rebuilds only the chunk it landed in.
+    // Rectangles stop at chunk borders. A chunk that reaches several physics
+    // partitions gets a body in each, holding the rectangles that reach it.
+    class TileColliderBuilder {
+    public:
+        // Call clear() after changing these; sync() only looks at revisions.
+        struct Settings {
+            size_t layer = 0;
+            glm::vec2 origin{ 0.0f }; // world position of tile (0, 0)'s corner
+            float tileSize = 32.0f;   // pixels
+            PhysicsBody fixture;      // material, filter and sensor flag; the rest is ignored
+        };
+
+        TileColliderBuilder(Registry& registry, PhysicsSystem& physics);
+
+        void setSolid(TileId id, bool solid);
+
+        // Rebuilds chunks that changed since the last sync and releases the
+        // bodies of chunks that no longer exist. The physics world must not
+        // be stepping. Returns the number of chunks rebuilt.
+        size_t sync(const TileMap& map);
+        // Destroys every chunk body and its entity.
+        void clear();
+
+        size_t getBodyCount() const { return chunks.size(); }
+        size_t getFixtureCount() const { return fixtureCount; }
+        // World-space rectangles of every chunk, for debug drawing.
+        void collectRects(std::vector<MergeRect>& out) const;
+
+        Settings settings;
+
+    private:
+        struct PartitionBody {
+            PartitionId partition;
+            Entity owner;
+        };
+        struct ChunkBody {
+            std::vector<PartitionBody> owners; // one per partition the chunk reaches
+            uint64_t revision = 0;
+            uint64_t seen = 0; // sync pass that last found the chunk in the map
+            std::vector<MergeRect> rects;
+        };
+
+        void rebuild(ChunkBody& body, int cx, int cy, const TileMap::Chunk& chunk);
+        void release(ChunkBody& body);
+        bool ownersAlive(const ChunkBody& body) const;
+
+        Registry& registry;
+        PhysicsSystem& physics;
+        std::vector<uint8_t> solid; // by TileId
+        std::unordered_map<int64_t, ChunkBody> chunks;
+        std::vector<TileRect> scratch;
+        std::vector<PartitionId> reached;
+        std::vector<std::vector<MergeRect>> byPartition;
+        size_t fixtureCount = 0;
+        uint64_t syncedRevision = 0;
+        uint64_t pass = 0;
+        bool rebuildAll = true;
+    };
+
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Chained {
+
+    using TileId = uint16_t;
+
+    // Layered tile map stored sparsely in square chunks. A chunk exists only
+    // while it holds a non-empty tile, so memory follows the painted area
+    // rather than the map's extent, and coordinates may be negative.
+    //
+    // Header-only and standard-library-only, so the editor tree can share it.
+    //
+    // Files are binary: a header, then per layer its name and chunks, each
+    // chunk run-length encoded as (count, id) pairs in row-major order.
+    // Fields are written in native (little-endian) byte order.
+    class TileMap {
+    public:
+        static constexpr int ChunkTiles = 32;
+        static constexpr int ChunkArea = ChunkTiles * ChunkTiles;
+        static constexpr TileId Empty = 0xFFFF;
+
+        struct Chunk {
+            std::array<TileId, ChunkArea> tiles;
+            uint32_t filled = 0;   // non-empty tiles; the chunk is freed at zero
+            uint64_t revision = 0; // map-wide unique stamp of the last change, for derived data such as colliders
+
+            Chunk() { tiles.fill(Empty); }
+            TileId at(int lx, int ly) const { return tiles[size_t(ly) * ChunkTiles + lx]; }
+        };
+
+        struct Layer {
+            std::string name;
+            std::unordered_map<int64_t, std::unique_ptr<Chunk>> chunks;
+        };
+
+        TileMap() { addLayer("base"); }
+
+        size_t addLayer(const std::string& name) {
+            layers.emplace_back();
+            layers.back().name = name;
+            return layers.size() - 1;
+        }
+        size_t getLayerCount() const { return layers.size(); }
+        const Layer& getLayer(size_t layer) const { return layers[layer]; }
+
+        void clear() {
+            layers.clear();
+            addLayer("base");
+            ++revision;
+        }
+
+        TileId get(size_t layer, int x, int y) const {
+            const Chunk* chunk = findChunk(layer, chunkCoord(x), chunkCoord(y));
+            return chunk ? chunk->at(x - chunkCoord(x) * ChunkTiles, y - chunkCoord(y) * ChunkTiles) : Empty;
+        }
+
+        // Returns false when the tile already had that id.
+        bool set(size_t layer, int x, int y, TileId id) {
+            if (layer >= layers.size()) return false;
+            const int cx = chunkCoord(x), cy = chunkCoord(y);
+            auto& chunks = layers[layer].chunks;
+            auto it = chunks.find(keyFor(cx, cy));
+            if (it == chunks.end()) {
+                if (id == Empty) return false;
+                it = chunks.emplace(keyFor(cx, cy), std::make_unique<Chunk>()).first;
+            }
+            Chunk& chunk = *it->second;
+            TileId& slot = chunk.tiles[size_t(y - cy * ChunkTiles) * ChunkTiles + size_t(x - cx * ChunkTiles)];
+            if (slot == id) return false;
+            if (slot == Empty) ++chunk.filled;
+            else if (id == Empty) --chunk.filled;
+            slot = id;
+            chunk.revision = ++revision;
+            if (chunk.filled == 0) chunks.erase(it);
+            return true;
+        }
+
+        const Chunk* findChunk(size_t layer, int cx, int cy) const {
+            if (layer >= layers.size()) return nullptr;
+            auto it = layers[layer].chunks.find(keyFor(cx, cy));
+            return it == layers[layer].chunks.end() ? nullptr : it->second.get();
+        }
+
+        // Calls fn(cx, cy, chunk) for every allocated chunk of a layer.
+        template <typename Fn>
+        void forEachChunk(size_t layer, Fn&& fn) const {
+            if (layer >= layers.size()) return;
+            for (const auto& [key, chunk] : layers[layer].chunks) {
+                fn(int(key >> 32), int(int32_t(uint32_t(key))), *chunk);
+            }
+        }
+
+        // Inclusive tile bounds of the painted area; false when nothing is painted.
+        bool getBounds(size_t layer, int& minX, int& minY, int& maxX, int& maxY) const {
+            bool any = false;
+            forEachChunk(layer, [&](int cx, int cy, const Chunk& chunk) {
+                for (int ly = 0; ly < ChunkTiles; ++ly) {
+                    for (int lx = 0; lx < ChunkTiles; ++lx) {
+                        if (chunk.at(lx, ly) == Empty) continue;
+                        int x = cx * ChunkTiles + lx, y = cy * ChunkTiles + ly;
+                        if (!any) { minX = maxX = x; minY = maxY = y; any = true; continue; }
+                        minX = std::min(minX, x); maxX = std::max(maxX, x);
+                        minY = std::min(minY, y); maxY = std::max(maxY, y);
+                    }
+                }
+            });
+            return any;
+        }
+
+        size_t getChunkCount() const {
+            size_t count = 0;
+            for (const Layer& layer : layers) count += layer.chunks.size();
+            return count;
+        }
+        uint64_t getRevision() const { return revision; } // bumped by any change
+
+        static int chunkCoord(int tile) {
+            return tile >= 0 ? tile / ChunkTiles : -((-tile + ChunkTiles - 1) / ChunkTiles);
+        }
+        static int64_t keyFor(int x, int y) { return (int64_t(x) << 32) ^ (uint32_t)y; }
+
+        bool save(const std::string& path) const {
+            std::vector<uint8_t> bytes;
+            FileHeader header{ FileMagic, FileVersion, uint32_t(layers.size()) };
+            append(bytes, &header, sizeof(header));
+            for (const Layer& layer : layers) {
+                uint32_t nameLength = uint32_t(layer.name.size());
+                uint32_t chunkCount = uint32_t(layer.chunks.size());
+                append(bytes, &nameLength, sizeof(nameLength));
+                append(bytes, layer.name.data(), nameLength);
+                append(bytes, &chunkCount, sizeof(chunkCount));
+                for (const auto& [key, chunk] : layer.chunks) {
+                    ChunkHeader chunkHeader{ int32_t(key >> 32), int32_t(uint32_t(key)), 0 };
+                    size_t headerAt = bytes.size();
+                    append(bytes, &chunkHeader, sizeof(chunkHeader));
+                    for (int i = 0; i < ChunkArea;) {
+                        Run run{ 0, chunk->tiles[i] };
+                        while (i < ChunkArea && chunk->tiles[i] == run.id) { ++run.count; ++i; }
+                        append(bytes, &run, sizeof(run));
+                        ++chunkHeader.runCount;
+                    }
+                    std::memcpy(bytes.data() + headerAt, &chunkHeader, sizeof(chunkHeader));
+                }
+            }
+
+            std::ofstream file(path, std::ios::binary);
+            if (!file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()))) {
+                std::cerr << "[ERROR] Could not write tile map: " << path << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        // Leaves the map untouched when the file is missing or malformed.
+        bool load(const std::string& path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) return false;
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            size_t cursor = 0;
+            FileHeader header;
+            if (!read(bytes, cursor, &header, sizeof(header)) || header.magic != FileMagic || header.version != FileVersion) {
+                std::cerr << "[ERROR] Not a tile map file: " << path << std::endl;
+                return false;
+            }
+            // Counts are checked against the bytes left before anything is
+            // sized by them: a layer takes at least its two length fields, a
+            // chunk its header and one run.
+            if (header.layerCount > (bytes.size() - cursor) / (2 * sizeof(uint32_t))) return malformed(path);
+            std::vector<Layer> loaded(header.layerCount);
+            for (Layer& layer : loaded) {
+                uint32_t nameLength = 0, chunkCount = 0;
+                if (!read(bytes, cursor, &nameLength, sizeof(nameLength)) || nameLength > bytes.size() - cursor) {
+                    return malformed(path);
+                }
+                layer.name.assign(reinterpret_cast<const char*>(bytes.data() + cursor), nameLength);
+                cursor += nameLength;
+                if (!read(bytes, cursor, &chunkCount, sizeof(chunkCount)) ||
+                    chunkCount > (bytes.size() - cursor) / (sizeof(ChunkHeader) + sizeof(Run))) {
+                    return malformed(path);
+                }
+                for (uint32_t c = 0; c < chunkCount; ++c) {
+                    ChunkHeader chunkHeader;
+                    if (!read(bytes, cursor, &chunkHeader, sizeof(chunkHeader)) ||
+                        chunkHeader.runCount > (bytes.size() - cursor) / sizeof(Run)) {
+                        return malformed(path);
+                    }
+                    auto chunk = std::make_unique<Chunk>();
+                    int i = 0;
+                    for (uint32_t r = 0; r < chunkHeader.runCount; ++r) {
+                        Run run;
+                        if (!read(bytes, cursor, &run, sizeof(run)) || run.count > ChunkArea - i) return malformed(path);
+                        std::fill_n(chunk->tiles.begin() + i, run.count, run.id);
+                        if (run.id != Empty) chunk->filled += run.count;
+                        i += run.count;
+                    }
+                    if (i != ChunkArea) return malformed(path);
+                    chunk->revision = ++revision;
+                    if (chunk->filled > 0) layer.chunks[keyFor(chunkHeader.x, chunkHeader.y)] = std::move(chunk);
+                }
+            }
+            if (loaded.empty()) loaded.emplace_back().name = "base";
+            layers = std::move(loaded);
+            return true;
+        }
+
+    private:
+        static constexpr uint32_t FileMagic = 0x50414D54; // "TMAP"
+        static constexpr uint32_t FileVersion = 1;
+
+        struct FileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t layerCount;
+        };
+        struct ChunkHeader {
+            int32_t x, y;      // chunk coordinates
+            uint32_t runCount;
+        };
+        struct Run {
+            uint16_t count;
+            TileId id;
+        };
+
+        static void append(std::vector<uint8_t>& bytes, const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), p, p + size);
+        }
+        static bool read(const std::vector<uint8_t>& bytes, size_t& cursor, void* out, size_t size) {
+            if (bytes.size() - cursor < size) return false;
+            std::memcpy(out, bytes.data() + cursor, size);
+            cursor += size;
+            return true;
+        }
+        static bool malformed(const std::string& path) {
+            std::cerr << "[ERROR] Tile map file is malformed: " << path << std::endl;
+            return false;
+        }
+
+        std::vector<Layer> layers;
+        uint64_t revision = 0;
+    };
+
+}
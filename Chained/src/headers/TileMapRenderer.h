@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+
+namespace Chained {
+
+    // Declared only, so the tile editor can include this next to its own
+    // copies of the Shader and Texture2D headers.
+    class Shader;
+    class Texture2D;
+
+    // Draws a tile map from tile ids kept on the GPU. The map is cut into
+    // square chunks; each chunk's ids live in a 16-bit integer texture and
+    // the chunk is drawn as one quad whose fragment shader texelFetches the
+    // id and then the tile's texel from the tileset. Cost per frame is one
+    // draw per visible chunk, whatever the tile count. Edits mark a dirty
+    // rectangle in their chunk, and only that rectangle is uploaded on the
+    // next draw.
+    class TileMapRenderer {
+    public:
+        static constexpr uint16_t EmptyTile = 0xFFFF; // never drawn
+
+        explicit TileMapRenderer(std::shared_ptr<Shader> shader, int chunkTiles = 32);
+        ~TileMapRenderer();
+
+        // Replaces the whole map; ids are row-major, width * height of them.
+        void setMap(int width, int height, const int* ids);
+        void setTile(int x, int y, int id);
+        int getTile(int x, int y) const;
+
+        // `tileset` holds tiles of tilePixels x tilePixels texels in rows of
+        // `columns`; tile id N is at column N % columns, row N / columns.
+        void setTileset(std::shared_ptr<Texture2D> tileset, int tilePixels, int columns);
+
+        // Draws the chunks overlapping [viewMin, viewMax] (world units).
+        // Tile (x, y) covers origin + [x, x + 1) * tileSize, same for y.
+        void draw(const glm::mat4& projection, glm::vec2 origin, float tileSize,
+                  glm::vec2 viewMin, glm::vec2 viewMax);
+
+        size_t getDrawCallCount() const { return m_drawCalls; }
+        size_t getUploadedTiles() const { return m_uploadedTiles; } // by the last draw
+
+    private:
+        struct Chunk {
+            GLuint texture = 0; // created on first upload
+            std::vector<uint16_t> ids;
+            glm::ivec2 dirtyMin{ 0 };
+            glm::ivec2 dirtyMax{ -1 }; // inclusive; empty when max < min
+        };
+
+        Chunk* chunkAt(int x, int y, glm::ivec2& local);
+        void markDirty(Chunk& chunk, glm::ivec2 local);
+        void upload(Chunk& chunk);
+        void releaseChunks();
+
+        std::shared_ptr<Shader> m_shader;
+        std::shared_ptr<Texture2D> m_tileset;
+        int m_tilePixels = 1;
+        int m_tilesetColumns = 1;
+        int m_chunkTiles;
+        int m_width = 0;
+        int m_height = 0;
+        int m_chunksX = 0;
+        int m_chunksY = 0;
+        std::vector<Chunk> m_chunks;
+        GLuint m_vao = 0;
+        GLuint m_vbo = 0;
+        size_t m_drawCalls = 0;
+        size_t m_uploadedTiles = 0;
+    };
+
+}
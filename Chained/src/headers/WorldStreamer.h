@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include <nlohmann/json.hpp>
+#include "types.h"
+#include "Registry.h"
+#include "JobSystem.h"
+#include "SceneLoader.h"
+#include "SpriteKernel.h"
+
+namespace Chained {
+
+    class Camera;
+    class FramePacket;
+    class PhysicsSystem;
+
+    // Streams a world split into square chunks of scene entities. Chunks near the
+    // camera (and ahead of it along its velocity) are loaded as background jobs;
+    // their physics bodies are created and destroyed a few per frame.
+    // Sprites of entities that never move are baked into one sprite list
+    // per chunk when it loads, and record() submits each visible chunk's
+    // list as one run instead of drawing those entities one by one.
+    //
+    // A world manifest is an ordinary scene file with a "world" block:
+    //   "world": { "chunkSize": 2048, "chunks": [ { "x": 0, "y": 0, "file": "..." } ] }
+    class WorldStreamer {
+    public:
+        struct Settings {
+            float loadMargin = 512.0f;      // pixels around the view that must be resident
+            float unloadMargin = 1536.0f;   // chunks further out than this are released
+            float prefetchSeconds = 1.0f;   // how far ahead along camera velocity to look
+            int bodyBudgetPerFrame = 256;   // bodies created or destroyed per update
+        };
+
+        WorldStreamer(Registry& registry, PhysicsSystem& physics, JobSystem& jobs);
+        ~WorldStreamer();
+
+        bool open(const nlohmann::json& worldJson);
+        void update(const Camera& camera, float dt);
+        void clear();
+
+        // Appends the baked sprites of resident chunks that overlap
+        // [viewMin, viewMax] to the current sprite pass, drawn with `texture`
+        // (the atlas bound to the registry).
+        void record(FramePacket& packet, const Texture2DPtr& texture, const glm::vec2& viewMin, const glm::vec2& viewMax) const;
+
+        size_t residentChunkCount() const { return resident.size(); }
+        size_t chunkCount() const { return chunks.size(); }
+        Settings settings;
+
+        // Splits a regular scene file into chunk files plus a manifest.
+        static bool cookScene(const std::string& sceneFile, const std::string& manifestFile, float chunkSize, JobSystem* jobs = nullptr);
+
+    private:
+        enum class ChunkState { Unloaded, Loading, Building, Resident, Releasing };
+
+        struct Chunk {
+            glm::ivec2 coord{ 0, 0 };
+            std::string file;
+            ChunkState state = ChunkState::Unloaded;
+            bool wanted = false;
+            JobHandle pending;
+            SceneLoader::SceneData loaded; // written by the job, read once it is done
+            std::vector<Entity> entities;
+            size_t bodyCursor = 0; // next entity to create or destroy a body for
+            SpriteList sprites;    // baked static sprites, see bakeSprites
+            glm::vec2 spriteMin{ 0.0f }, spriteMax{ 0.0f };
+        };
+
+        static int64_t keyFor(int x, int y) { return (int64_t(x) << 32) ^ (uint32_t)y; }
+        void requestRange(const glm::vec2& min, const glm::vec2& max);
+        void pollLoads();
+        void bakeSprites(Chunk& chunk);
+        void buildBodies(int& budget);
+        void releaseChunks(int& budget);
+
+        Registry& registry;
+        PhysicsSystem& physics;
+        JobSystem& jobs;
+        float chunkSize = 2048.0f;
+        std::vector<Chunk> chunks;
+        std::unordered_map<int64_t, size_t> chunkIndex;
+        std::vector<Chunk*> loading;
+        std::vector<Chunk*> resident; // building, resident or releasing
+        glm::vec2 lastCameraPos{ 0.0f };
+        bool hasLastCamera = false;
+    };
+
+}
@@ -1,35 +1,333 @@
 
 #pragma once
 #include <box2d/box2d.h>
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include "types.h" // where you define SceneObject
-#include "DebugDraw.h"
+#include "Registry.h"
+#include "JobSystem.h"
+#include "ColliderMerge.h"
 
 namespace Chained {
 
+    using PartitionId = uint32_t;
+
+    // A contact callback from Box2D, recorded as plain data and reported
+    // after the step that caused it. Within a step, partitions report in id
+    // order and each partition in Box2D's own order, so the sequence is
+    // deterministic even though partitions step in parallel.
+    //
+    // Begin/End fire once per touch. PreSolve and PostSolve fire every step
+    // for every touching non-sensor contact, so they are only recorded when
+    // enabled with setContactEventMask.
+    struct ContactEvent {
+        enum class Type : uint8_t { Begin, End, PreSolve, PostSolve };
+        enum Flags : uint8_t { SensorA = 1, SensorB = 2 };
+
+        Type type;
+        uint8_t flags; // Flags
+        PartitionId partition;
+        Entity a;
+        Entity b;
+        glm::vec2 point{ 0.0f };  // pixels, first manifold point; zero for End and sensors
+        glm::vec2 normal{ 0.0f }; // from a to b
+        float approachSpeed = 0.0f;  // PreSolve: closing speed along the normal, pixels/s
+        float normalImpulse = 0.0f;  // PostSolve: summed over the manifold points
+        float tangentImpulse = 0.0f; // PostSolve: friction, summed likewise
+
+        bool isSensor() const { return flags & (SensorA | SensorB); }
+    };
+
+    // Contacts alive in the broadphase: every pair the collision filter let
+    // through costs a narrowphase update per step, touching or not.
+    struct ContactStats {
+        size_t pairs = 0;
+        size_t touching = 0;
+    };
+
+    inline constexpr uint8_t contactEventBit(ContactEvent::Type type) { return uint8_t(1u << uint8_t(type)); }
+
+    // Dynamic state of a PhysicsSystem as one flat byte buffer: a header,
+    // then packed per-body and per-contact records. Entities are stored by
+    // handle, so a snapshot only restores into the system (and bodies) it
+    // was taken from, which is what rollback and restarts need.
+    struct PhysicsSnapshot {
+        std::vector<uint8_t> bytes;
+        size_t size() const { return bytes.size(); }
+        bool empty() const { return bytes.empty(); }
+    };
+
+    // Which fixtures a query sees, using Box2D's category/mask convention:
+    // a fixture passes when each side's mask accepts the other's category.
+    struct QueryFilter {
+        uint16_t categoryBits = 0xFFFF;
+        uint16_t maskBits = 0xFFFF;
+        bool includeSensors = false;
+        Entity ignore = NullEntity; // typically the querying entity itself
+    };
+
+    // Queries take pixels, like Transform.
+    struct RayQuery {
+        glm::vec2 from;
+        glm::vec2 to;
+        QueryFilter filter;
+    };
+
+    struct AabbQuery {
+        glm::vec2 min;
+        glm::vec2 max;
+        QueryFilter filter;
+    };
+
+    // A box or circle swept from `from` to `to`.
+    struct ShapeCastQuery {
+        ShapeType shape = ShapeType::Box;
+        glm::vec2 size{ 0.0f }; // box
+        float radius = 0.0f;    // circle
+        float rotation = 0.0f;
+        glm::vec2 from;
+        glm::vec2 to;
+        QueryFilter filter;
+    };
+
+    // Closest hit of a ray or cast; entity is NullEntity when nothing was hit.
+    struct QueryHit {
+        Entity entity = NullEntity;
+        glm::vec2 point{ 0.0f };
+        glm::vec2 normal{ 0.0f };
+        float fraction = 1.0f; // along from -> to
+    };
+
+    // Overlaps of many AABB queries in one flat array: query i owns
+    // entities[first[i], first[i] + count[i]).
+    struct OverlapResults {
+        std::vector<Entity> entities;
+        std::vector<uint32_t> first;
+        std::vector<uint32_t> count;
+    };
+
     class PhysicsSystem {
        
     public:
         static constexpr float PHYSICS_SCALE = 32.0f;
+        static constexpr size_t SYNC_GRAIN = 1024;
+        static constexpr size_t QUERY_GRAIN = 64;
+        static constexpr size_t CONTACT_EVENT_RESERVE = 256; // per partition, grows as needed
 
-        PhysicsSystem(const b2Vec2& gravity);
+        PhysicsSystem(Registry& registry, const b2Vec2& gravity);
         ~PhysicsSystem();
 
-        void addObjects(std::vector<std::unique_ptr<SceneObject>>& objects);
+        // Bodies are created in the partition whose region contains their
+        // position (see addPartition), or in partition 0 otherwise.
+        // Creates bodies for every entity with an enabled Collider.
+        void addObjects();
+        void addEntity(Entity e);
+        void removeEntity(Entity e);
+        // Disabled bodies leave the broadphase and the solver but keep their
+        // fixtures; they are not synced, stepped or captured in snapshots
+        // until enabled again.
+        void setBodyEnabled(Entity e, bool enabled);
         void step(float dt);
-        void syncToObjects(std::vector<std::unique_ptr<SceneObject>>& objects);
+        // Copies poses of awake dynamic/kinematic bodies into Transform.
+        // Static bodies are never visited. Large sets are split across the
+        // job system when one is given.
+        void syncToRegistry(JobSystem* jobs = nullptr);
+        // Destroys every body and drops all partitions but 0.
         void clear();
 
-        b2Body* getBodyFor(SceneObject* obj);
+        // Load-time pass for wall-heavy levels: static, unrotated, non-sensor
+        // boxes that touch are replaced by one static body per connected
+        // region, with a chain loop around its outline and one per hole.
+        // Boxes are only merged with boxes of the same material and filter,
+        // and a region is left alone when its outline would need as many
+        // edges (broadphase proxies) as it has boxes. The new bodies belong
+        // to fresh entities with no other components; the boxes' entities
+        // keep their Collider but lose their body, so calling addObjects
+        // again would recreate them. Chains collide on their outer side
+        // only. Run it after partitions are set up. Returns the number of
+        // boxes merged.
+        size_t mergeStaticColliders();
+        // Outlines of the merged regions, in pixels, for debug drawing.
+        const std::vector<std::vector<glm::vec2>>& getMergedOutlines() const { return mergedOutlines; }
+        // Gives `owner` one static body in `partition` with a box fixture per
+        // rect (pixels, world space), using desc's material, filter and
+        // sensor flag. Any body the owner already had is destroyed first; no
+        // rects leaves it without one. Static geometry crossing a partition
+        // border needs a body in each partition it reaches (see
+        // partitionsOverlapping).
+        void setStaticBoxes(Entity owner, const MergeRect* rects, size_t count, const PhysicsBody& desc,
+                            PartitionId partition);
+
+        // Partitions are separate b2Worlds for areas that never interact
+        // physically (rooms, dungeon regions); beginStep steps them in
+        // parallel. A new partition adopts the bodies of partition 0 that lie
+        // inside [min, max) (pixels). Partition 0 is the catch-all.
+        PartitionId addPartition(const glm::vec2& min, const glm::vec2& max);
+        size_t getPartitionCount() const { return partitions.size(); }
+        PartitionId partitionAt(const glm::vec2& position) const;
+        PartitionId partitionOf(Entity e) const;
+        // Every partition whose region meets [min, max], plus partition 0
+        // unless one region contains it all. Appends to `out`.
+        void partitionsOverlapping(const glm::vec2& min, const glm::vec2& max, std::vector<PartitionId>& out) const;
+        // Recreates the body in `target` with the same pose, velocities,
+        // sleep state and fixtures. The world must not be stepping. Contacts
+        // the rebuilt body makes again on its first step in `target` raise
+        // no End/Begin pair; the others end with that step's events.
+        bool moveToPartition(Entity e, PartitionId target);
+        // Moves bodies that crossed into another partition's region since the
+        // last publish. Only looks at getMovedEntities().
+        void migrateMovedBodies();
+
+        // Captures poses, velocities and sleep state of every moving body, plus
+        // warm-start impulses of touching contacts. Restore writes them back
+        // through Box2D's public API and publishes the poses to Transform.
+        // Box2D 2.4 keeps sleep timers and continuous-collision sweeps
+        // private: restored awake bodies start a fresh sleep timer, and
+        // contacts that do not exist at restore time begin again on the next
+        // step without warm starting.
+        void saveSnapshot(PhysicsSnapshot& out);
+        bool restoreSnapshot(const PhysicsSnapshot& snapshot);
+        double getLastSaveMicros() const { return lastSaveMicros; }
+        double getLastRestoreMicros() const { return lastRestoreMicros; }
+
+        // Contacts from the steps published by the last sync or finishStep,
+        // one flat array meant to be consumed in bulk (or split across jobs)
+        // after the step. The arrays keep their capacity between steps, so
+        // recording stops allocating once they have grown to the busiest step.
+        const std::vector<ContactEvent>& getContactEvents() const { return contactEvents; }
+        // Which event types are recorded, as contactEventBit flags. Defaults
+        // to Begin and End.
+        void setContactEventMask(uint8_t mask);
+        ContactStats getContactStats();
+        uint8_t getContactEventMask() const { return contactEventMask; }
+
+        // Asynchronous stepping. beginStep applies queued commands and runs
+        // the step (plus pose capture into a back buffer) as jobs, so the
+        // caller can render from Transform while Box2D works. finishStep, at
+        // the next frame boundary, waits and copies the captured poses into
+        // Transform. Between the two the world belongs to the jobs: only the
+        // queue* calls below are allowed. Without a job system beginStep
+        // steps inline and finishStep only publishes.
+        void beginStep(float dt, JobSystem* jobs);
+        void finishStep();
+        bool isStepping() const { return !JobSystem::isDone(pendingStep); }
+
+        // Applied at the start of the next step, in call order.
+        void queueLinearVelocity(Entity e, const b2Vec2& velocity);
+        void queueForce(Entity e, const b2Vec2& force);
+        void queueImpulse(Entity e, const b2Vec2& impulse);
+
+        // Entities whose Transform was written by the last sync or finishStep,
+        // for downstream dirty tracking. Valid until the next one.
+        const std::vector<Entity>& getMovedEntities() const { return movedEntities; }
+        size_t getMovingBodyCount() const { return moving.size(); }
+
+        b2Body* getBodyFor(Entity e);
+        // Teleports the body (pixels, radians). The pose is published by the
+        // next step even when the body sleeps; prefer this to calling
+        // SetTransform on getBodyFor directly. The world must not be stepping.
+        void setTransform(Entity e, const glm::vec2& position, float rotation);
+
+        // Batched scene queries across every partition. Results are written
+        // per query, in query order. With a job system, large batches run in
+        // parallel ranges; the world is read-only while they do, so any
+        // in-flight step is waited out first.
+        void raycast(const RayQuery* queries, size_t count, QueryHit* hits, JobSystem* jobs = nullptr);
+        void shapeCast(const ShapeCastQuery* queries, size_t count, QueryHit* hits, JobSystem* jobs = nullptr);
+        void overlap(const AabbQuery* queries, size_t count, OverlapResults& out, JobSystem* jobs = nullptr);
+        QueryHit raycast(const RayQuery& query) { QueryHit hit; raycast(&query, 1, &hit); return hit; }
         
         // Get the Box2D world for debug drawing
-        b2World* getWorld() const { return world; }
+        b2World* getWorld(PartitionId partition = 0) const { return &partitions[partition]->world; }
         
     private:
-        b2World* world = nullptr;
-        std::unordered_map<SceneObject*, b2Body*> bodyMap;
+        // One world plus the contact events it produced since the last publish.
+        struct Partition : b2ContactListener {
+            Partition(PartitionId id, const b2Vec2& gravity, const glm::vec2& min, const glm::vec2& max);
+
+            void BeginContact(b2Contact* contact) override;
+            void EndContact(b2Contact* contact) override;
+            void PreSolve(b2Contact* contact, const b2Manifold* oldManifold) override;
+            void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override;
+
+            // Entities, sensor flags and world point/normal of a contact.
+            ContactEvent makeEvent(ContactEvent::Type type, b2Contact* contact) const;
+
+            PartitionId id;
+            uint8_t eventMask = 0; // copied from the system; read by the listener during the step
+            mutable b2World world;
+            glm::vec2 min, max;
+            std::vector<ContactEvent> contacts;
+            // Set while moveToPartition destroys its body here; its End
+            // events go to `held` instead of `contacts`.
+            Entity migrating = NullEntity;
+            std::vector<ContactEvent> held;
+        };
+
+        struct BodyCommand {
+            enum class Type { SetLinearVelocity, ApplyForce, ApplyImpulse };
+            Type type;
+            Entity entity;
+            b2Vec2 value;
+        };
+        // A body that can move, with the entity from its user data.
+        struct MovingBody {
+            b2Body* body;
+            Entity entity;
+            bool wasAwake = true; // as of the last capture
+            bool dirty = false;   // teleported; publish even if asleep
+        };
+        // Pose captured right after a step, in pixels.
+        struct BodyPose {
+            Entity entity;
+            glm::vec2 position;
+            float rotation;
+        };
+
+        static constexpr uint32_t NoSlot = 0xFFFFFFFFu;
+
+        void trackMoving(Entity e, b2Body* body);
+        void untrackMoving(Entity e);
+        void stepPartition(Partition& partition, float dt);
+        QueryHit raycastOne(const RayQuery& query) const;
+        QueryHit shapeCastOne(const ShapeCastQuery& query) const;
+        void overlapOne(const AabbQuery& query, std::vector<Entity>& out) const;
+        template <typename Fn>
+        void runQueries(size_t count, JobSystem* jobs, Fn&& fn);
+        void applyCommands();
+        // Fills poses/awake for moving slots [first, last).
+        void capturePoses(size_t first, size_t last);
+        void markDirty(Entity e);
+        void publishPoses();
+        void mergeContacts();
+        void pairMigratedContacts();
+        // Structural changes wait out any in-flight step; its poses stay pending.
+        void waitForStep();
+
+        Registry& registry;
+        b2Vec2 gravity;
+        std::vector<std::unique_ptr<Partition>> partitions; // stable addresses for the listeners
+        std::vector<ContactEvent> contactEvents;
+        std::vector<ContactEvent> migratedEnds; // held back by moveToPartition until the next merge
+        std::vector<std::vector<glm::vec2>> mergedOutlines;
+        uint8_t contactEventMask = contactEventBit(ContactEvent::Type::Begin) | contactEventBit(ContactEvent::Type::End);
+
+        std::vector<BodyCommand> commands;
+
+        // Dynamic and kinematic bodies only, packed; movingSlot maps an
+        // entity index to its slot here.
+        std::vector<MovingBody> moving;
+        std::vector<uint32_t> movingSlot;
+
+        // Back buffer, slot-aligned with `moving` as of the last capture.
+        std::vector<BodyPose> poses;
+        std::vector<uint8_t> awake;
+        std::vector<Entity> movedEntities;
+        bool posesPending = false;
+        double lastSaveMicros = 0.0;
+        double lastRestoreMicros = 0.0;
+        JobHandle pendingStep;
+        JobSystem* stepJobs = nullptr;
     };
 
 }
@@ -19,6 +19,13 @@ namespace Chained{
     class ResourceManager
     {
     public:
+        struct DecodedImage {
+            unsigned char* pixels = nullptr;
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+        };
+
         std::map<std::string, std::shared_ptr<Shader>> m_shaderMap;
         std::map<std::string, std::shared_ptr<Texture2D>> m_textureMap;
 
@@ -34,6 +41,11 @@ namespace Chained{
         ShaderPtr getShader(const std::string& name);
         Texture2DPtr loadTexture(const GLchar* file, GLboolean alpha, const std::string& name);
         Texture2DPtr getTexture(const std::string& name);
+        // Texture loading split in two so decoding can run as a job: decodeImage
+        // touches no GL state, createTexture uploads (on the GL thread) and
+        // frees the pixels.
+        bool decodeImage(const std::string& file, DecodedImage& out);
+        Texture2DPtr createTexture(DecodedImage& image, GLboolean alpha, const std::string& name);
         void clear();
         std::string solveResourcePath(const std::string& path);
 
@@ -41,6 +53,7 @@ namespace Chained{
         ResourceManager();
         Shader* loadShaderFromFile(const GLchar* vShaderFile, const GLchar* fShaderFile, const GLchar* gShaderFile = nullptr);
         Texture2D* loadTextureFromFile(const GLchar* file, GLboolean alpha);
+        Texture2D* uploadImage(DecodedImage& image, GLboolean alpha);
         static ResourceManager* m_instance;
         std::vector<std::string> m_searchPath;
     };
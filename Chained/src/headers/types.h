@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <glm/glm.hpp>
@@ -11,7 +12,6 @@ namespace Chained {
 	using GameObjectPtr = std::shared_ptr<class GameObject>;
 	using PlayerPtr = std::shared_ptr<class Player>;
 	using EnemyPtr = std::shared_ptr<class Enemy>;
-	using BulletPtr = std::shared_ptr<class Bullet>;
 	using RoomPtr = std::shared_ptr<class Room>;
 	using DungeonPtr = std::shared_ptr<class Dungeon>;
 
@@ -20,6 +20,10 @@ namespace Chained {
 	using InputManagerPtr = std::shared_ptr<class InputManager>;
 	using AudioManagerPtr = std::shared_ptr<class AudioManager>;
 
+	// Index into a SpriteAtlas slice table, see SpriteAtlas::resolveSlice.
+	using SliceHandle = uint32_t;
+	constexpr SliceHandle InvalidSlice = 0xFFFFFFFFu;
+
 
 	struct PhysicsMaterial {
 		float friction = 0.5f;
@@ -41,6 +45,13 @@ namespace Chained {
 		float angularDamping = 0.0f;
 		bool fixedRotation = false;
 		bool isSensor = false;
+		// Box2D collision filtering. Two fixtures collide when each one's mask
+		// has the other's category bit; a shared nonzero group overrides that,
+		// always colliding when positive and never when negative. Filtered
+		// pairs never reach the narrowphase.
+		uint16_t categoryBits = 0x0001;
+		uint16_t maskBits = 0xFFFF;
+		int16_t groupIndex = 0;
 		PhysicsMaterial material;
 		glm::vec2 size = { 1.0f, 1.0f };
 		float radius = 0.5f;
@@ -3,6 +3,7 @@
 #include "../../headers/GameState.h"
 #include "../../headers/AppState.h"
 #include "../../headers/Engine.h"
+#include "../../../headers/TileMap.h"
 #include <vector>
 #include <memory>
 
@@ -11,11 +12,13 @@ namespace Chained {
     // forward declarations to avoid heavy includes
     class SpriteRenderer;
     class Texture2D;
+    class TileMapRenderer;
 
     class DebugEditorState : public GameState
     {
     public:
         explicit DebugEditorState(Engine* eng);    // constructor
+        ~DebugEditorState();
 
         void onEnter()  override;
         void onExit() override;
@@ -23,26 +26,16 @@ namespace Chained {
         void render()   override;
         AppState result = AppState::Editor;   // ← ADD THIS
     private:
-        /* ───── minimal tile grid ───── */
-        struct TileMap {
-            int w = 20;
-            int h = 15;
-            std::vector<int> tiles;
-
-            TileMap() : tiles(w* h, 0) {}
-
-            int& at(int x, int y) { return tiles[y * w + x]; }
-            int  at(int x, int y) const { return tiles[y * w + x]; }
-
-            void save(const char* path) const;
-            bool load(const char* path);
-        };
+        void loadMap();
+        bool importLegacyMap(const char* path); // the old room.json int grid
+        void uploadMap();                       // whole visible grid to tileRenderer
 
         /* members */
         Engine* engine = nullptr;
         TileMap                       map;
-        int                           current = 1;        // selected tile id
+        int                           current = 1;        // selected tile id, TileMap::Empty erases
         std::unique_ptr<SpriteRenderer> renderer;            // draws quads
+        std::unique_ptr<TileMapRenderer> tileRenderer;       // draws the map, one quad per chunk
         std::shared_ptr<Texture2D>    whiteTex;              // 1×1 white
     };
 
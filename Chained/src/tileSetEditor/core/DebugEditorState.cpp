@@ -5,6 +5,7 @@
 #include <fstream> // Add this include to resolve the incomplete type error for std::ofstream
 #include "../headers/SpriteRenderer.h"
 #include "../headers/Texture2D.h"
+#include "../../headers/TileMapRenderer.h"
 #include "../headers/Engine.h"
 #include "../headers/resourceManager.h"
 #include <iostream>
@@ -14,7 +15,11 @@ namespace Chained {
 
     /* ───────────── constants ───────────── */
     constexpr int TILE = 32;
-    constexpr char SAVE_PATH[] = "room.json";
+    constexpr char SAVE_PATH[] = "room.tilemap";
+    constexpr char LEGACY_PATH[] = "room.json";
+    /* visible grid; the map itself is unbounded */
+    constexpr int GRID_W = Engine::SCREEN_WIDTH / TILE;
+    constexpr int GRID_H = Engine::SCREEN_HEIGHT / TILE;
 
     /* colour for each debug tile id */
     static glm::vec3 colorFor(int id)
@@ -32,23 +37,38 @@ namespace Chained {
     void DebugEditorState::onExit() {}
     /* ───────── constructor ───────── */
     DebugEditorState::DebugEditorState(Engine* eng) : engine(eng) {}
+    DebugEditorState::~DebugEditorState() = default;
 
     /* ───────── TileMap save/load ───────── */
-    void DebugEditorState::TileMap::save(const char* path) const
+    void DebugEditorState::loadMap()
     {
-        json j{ {"w", w}, {"h", h}, {"tiles", tiles} };
-        std::ofstream(path) << j.dump(2);
+        if (!map.load(SAVE_PATH) && importLegacyMap(LEGACY_PATH))
+            std::cout << "[INFO] Imported " << LEGACY_PATH << ", saving writes " << SAVE_PATH << std::endl;
+        uploadMap();
     }
-    bool DebugEditorState::TileMap::load(const char* path)
+    bool DebugEditorState::importLegacyMap(const char* path)
     {
         std::ifstream f(path);
         if (!f.is_open()) return false;
-        json j; f >> j;
-        w = j["w"];  h = j["h"];
-        tiles = j["tiles"].get<std::vector<int>>();
-        if ((int)tiles.size() != w * h) tiles.assign(w * h, 0);
+        json j = json::parse(f, nullptr, false);
+        if (j.is_discarded() || !j.contains("tiles")) return false;
+        int w = j.value("w", 0), h = j.value("h", 0);
+        std::vector<int> tiles = j["tiles"].get<std::vector<int>>();
+        if ((int)tiles.size() != w * h) return false;
+        map.clear();
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                map.set(0, x, y, TileId(tiles[y * w + x]));
         return true;
     }
+    void DebugEditorState::uploadMap()
+    {
+        std::vector<int> ids(size_t(GRID_W) * GRID_H);
+        for (int y = 0; y < GRID_H; ++y)
+            for (int x = 0; x < GRID_W; ++x)
+                ids[size_t(y) * GRID_W + x] = map.get(0, x, y);
+        tileRenderer->setMap(GRID_W, GRID_H, ids.data());
+    }
 
     /* ───────── onEnter ───────── */
     void DebugEditorState::onEnter()
@@ -69,7 +89,24 @@ namespace Chained {
         // --- END BLOCK ---
 
         whiteTex = Texture2D::Create(1, 1, 0xFFFFFFFFu);
-        map.load(SAVE_PATH);
+
+        // The debug colours become a one-texel-per-tile tileset.
+        constexpr int TILE_IDS = 6;
+        uint8_t palette[TILE_IDS * 4];
+        for (int id = 0; id < TILE_IDS; ++id) {
+            glm::vec3 c = colorFor(id);
+            palette[id * 4 + 0] = uint8_t(c.r * 255.0f);
+            palette[id * 4 + 1] = uint8_t(c.g * 255.0f);
+            palette[id * 4 + 2] = uint8_t(c.b * 255.0f);
+            palette[id * 4 + 3] = 255;
+        }
+        auto paletteTex = std::make_shared<Texture2D>();
+        paletteTex->generate(TILE_IDS, 1, palette);
+        auto tileShader = rm.loadShader("tilemap.vert", "tilemap.frag", nullptr, "tilemap");
+        tileRenderer = std::make_unique<TileMapRenderer>(tileShader);
+        tileRenderer->setTileset(paletteTex, 1, TILE_IDS);
+
+        loadMap();
     }
     /* ───────── update ───────── */
     void DebugEditorState::update(float /*dt*/)
@@ -87,7 +124,7 @@ namespace Chained {
         }
         // Press L to load
         if (glfwGetKey(engine->getWindow(), GLFW_KEY_L) == GLFW_PRESS) {
-            map.load(SAVE_PATH);
+            loadMap();
             std::cout << "Loaded!\n";
         }
 
@@ -107,7 +144,7 @@ namespace Chained {
         }
         if (ImGui::Button("Save")) map.save(SAVE_PATH);
         ImGui::SameLine();
-        if (ImGui::Button("Load")) map.load(SAVE_PATH);
+        if (ImGui::Button("Load")) loadMap();
         ImGui::End();
 
         auto& io = ImGui::GetIO();
@@ -115,8 +152,8 @@ namespace Chained {
             double mx, my; glfwGetCursorPos(glfwGetCurrentContext(), &mx, &my);
             int gx = int(mx) / TILE;
             int gy = int(my) / TILE;
-            if (gx >= 0 && gx < map.w && gy >= 0 && gy < map.h)
-                map.at(gx, gy) = current;
+            if (gx >= 0 && gx < GRID_W && gy >= 0 && gy < GRID_H && map.set(0, gx, gy, TileId(current)))
+                tileRenderer->setTile(gx, gy, current);
         }
         */
 
@@ -126,8 +163,8 @@ namespace Chained {
             glfwGetCursorPos(engine->getWindow(), &mx, &my);
             int gx = int(mx) / TILE;
             int gy = int(my) / TILE;
-            if (gx >= 0 && gx < map.w && gy >= 0 && gy < map.h)
-                map.at(gx, gy) = current;
+            if (gx >= 0 && gx < GRID_W && gy >= 0 && gy < GRID_H && map.set(0, gx, gy, TileId(current)))
+                tileRenderer->setTile(gx, gy, current); // re-uploads just this tile
         }
 
         // Simple keyboard input for tile selection
@@ -137,27 +174,20 @@ namespace Chained {
         if (glfwGetKey(engine->getWindow(), GLFW_KEY_4) == GLFW_PRESS) current = 4;
         if (glfwGetKey(engine->getWindow(), GLFW_KEY_5) == GLFW_PRESS) current = 5;
         if (glfwGetKey(engine->getWindow(), GLFW_KEY_0) == GLFW_PRESS) current = 0;
+        if (glfwGetKey(engine->getWindow(), GLFW_KEY_E) == GLFW_PRESS) current = TileMap::Empty;
     }
 
     /* ───────── render ───────── */
     void DebugEditorState::render()
     {
         std::cout << "IN EDITOR RENDER\n";
-        // draw your map grid (like you have now)
-        for (int y = 0; y < map.h; ++y)
-            for (int x = 0; x < map.w; ++x)
-            {
-                glm::vec2 pos{ x * TILE, y * TILE };
-                glm::vec3 col = colorFor(map.at(x, y));
-                renderer->DrawSprite(
-                    whiteTex,
-                    pos,
-                    { TILE, TILE },
-                    0.0f,
-                    col,
-                    { 0,0,1,1 }
-                );
-            }
+        // The whole grid is one quad per visible chunk of tiles.
+        glm::mat4 projection = glm::ortho(
+            0.0f, float(Engine::SCREEN_WIDTH),
+            float(Engine::SCREEN_HEIGHT), 0.0f, -1.0f, 1.0f
+        );
+        tileRenderer->draw(projection, glm::vec2(0.0f), float(TILE),
+            glm::vec2(0.0f), glm::vec2(Engine::SCREEN_WIDTH, Engine::SCREEN_HEIGHT));
         // draw a big red box at 0,0 so you know render() is being called
         renderer->DrawSprite(
             whiteTex,